@@ -0,0 +1,424 @@
+#include "types.h"
+#include "graph.h"
+#include "gen.h"
+#include "phase.h"
+#include "tc.h"
+#ifdef PARALLEL
+#include "tc_parallel.h"
+#include <omp.h>
+#endif
+#include "auto.h"
+
+#define AUTO_STREAM  0x6175746fULL   /* random stream of the calibration samples */
+
+/* What the operation count of a candidate is proportional to */
+enum autoWork_t { WORK_SUM_SQUARES = 0, WORK_FORWARD, WORK_FORWARD_DEGREE, WORK_BADER };
+
+typedef struct {
+  const char *name;
+  UINT_t (*f)(const GRAPH_TYPE *);
+  bool parallel;
+  enum autoWork_t work;
+  double alpha;   /* seconds per unit of work */
+  double beta;    /* seconds per vertex and adjacency list entry */
+} autoCandidate_t;
+
+/* The defaults are the mean of three --calibrate profiles (seeds 1-3)
+   of RMAT scale 16 on one thread of a small x86-64 machine (gcc -O2);
+   calibrate for the real one. */
+static autoCandidate_t candidates[] = {
+  { "tc_forward_hash",             tc_forward_hash,             false, WORK_FORWARD,        1.40e-10, 8.36e-08 },
+  { "tc_forward_hash_degreeOrder", tc_forward_hash_degreeOrder, false, WORK_FORWARD_DEGREE, 8.89e-10, 2.24e-08 },
+  { "tc_bader_forward_hash",       tc_bader_forward_hash,       false, WORK_FORWARD,        6.68e-10, 3.17e-08 },
+  { "tc_intersect_Hash_DO",        tc_intersectHash_DO,         false, WORK_SUM_SQUARES,    1.02e-09, 0.00e+00 },
+  { "tc_intersect_MergePath_DO",   tc_intersectMergePath_DO,    false, WORK_SUM_SQUARES,    1.26e-09, 1.82e-07 },
+#ifdef PARALLEL
+  { "tc_forward_hash_P",           tc_forward_hash_P,           true,  WORK_FORWARD,        2.74e-10, 4.30e-08 },
+  { "tc_MapJIK_P",                 tc_MapJIK_P,                 true,  WORK_FORWARD_DEGREE, 7.68e-10, 4.11e-08 },
+  { "tc_bader_bfs3_P",             tc_bader_bfs3_P,             true,  WORK_BADER,          1.29e-09, 7.93e-08 },
+  { "tc_intersect_Hash_DO_P",      tc_intersectHash_DO_P,       true,  WORK_SUM_SQUARES,    4.76e-10, 2.10e-07 },
+  { "tc_intersect_MergePath_DO_P", tc_intersectMergePath_DO_P,  true,  WORK_SUM_SQUARES,    1.50e-09, 6.08e-08 },
+#endif
+};
+
+static const int numCandidates = sizeof(candidates) / sizeof(candidates[0]);
+
+/* Fraction of the undirected edges that join two vertices on the same
+   level of a BFS forest */
+static double horizontal_fraction(const GRAPH_TYPE *graph) {
+  const UINT_t* restrict Ap = graph->rowPtr;
+  const VERTEX_t* restrict Ai = graph->colInd;
+  const UINT_t n = graph->numVertices;
+  const UINT_t NO_LEVEL = n;
+  UINT_t k = 0;
+
+  if (graph->numEdges == 0) return 0.0;
+
+  UINT_t *level = (UINT_t *)malloc(n * sizeof(UINT_t));
+  assert_malloc(level);
+  UINT_t *queue = (UINT_t *)malloc(n * sizeof(UINT_t));
+  assert_malloc(queue);
+
+  for (UINT_t v = 0 ; v < n ; v++)
+    level[v] = NO_LEVEL;
+
+  for (UINT_t r = 0 ; r < n ; r++) {
+    if (level[r] != NO_LEVEL) continue;
+    UINT_t head = 0, tail = 0;
+    level[r] = 0;
+    queue[tail++] = r;
+    while (head < tail) {
+      const UINT_t v = queue[head++];
+      for (UINT_t i = Ap[v] ; i < Ap[v+1] ; i++) {
+	const UINT_t w = Ai[i];
+	if (level[w] == NO_LEVEL) {
+	  level[w] = level[v] + 1;
+	  queue[tail++] = w;
+	}
+	else if ((v < w) && (level[w] == level[v]))
+	  k++;
+      }
+    }
+  }
+
+  free(queue);
+  free(level);
+
+  return 2.0 * (double)k / (double)graph->numEdges;
+}
+
+static void features(const GRAPH_TYPE *graph, graphFeatures_t *f, const bool parallel) {
+  const UINT_t* restrict Ap = graph->rowPtr;
+  const VERTEX_t* restrict Ai = graph->colInd;
+  const UINT_t n = graph->numVertices;
+  UINT_t maxDegree = 0, maxUpDegree = 0;
+  double wedges = 0.0, sumSquares = 0.0, forwardWork = 0.0, forwardDegreeWork = 0.0;
+
+  (void)parallel;
+#ifdef PARALLEL
+#pragma omp parallel for if(parallel) schedule(dynamic,1024) reduction(max:maxDegree,maxUpDegree) \
+  reduction(+:wedges,sumSquares,forwardWork,forwardDegreeWork)
+#endif
+  for (UINT_t v = 0 ; v < n ; v++) {
+    const UINT_t d = Ap[v+1] - Ap[v];
+    /* Neighbors before v in vertex order and in decreasing degree order */
+    UINT_t before = 0, beforeDegree = 0, up = 0;
+    for (UINT_t i = Ap[v] ; i < Ap[v+1] ; i++) {
+      const UINT_t w = Ai[i];
+      const UINT_t dw = Ap[w+1] - Ap[w];
+      if (w < v) before++;
+      if ((dw > d) || ((dw == d) && (w < v))) beforeDegree++;
+      if (dw >= d) up++;
+    }
+    if (d > maxDegree) maxDegree = d;
+    if (up > maxUpDegree) maxUpDegree = up;
+    wedges += 0.5 * (double)d * ((double)d - 1.0);
+    sumSquares += (double)d * (double)d;
+    forwardWork += (double)before * (double)d;
+    forwardDegreeWork += (double)beforeDegree * (double)d;
+  }
+
+  f->n = n;
+  f->m = graph->numEdges / 2;
+  f->maxDegree = maxDegree;
+  f->maxUpDegree = maxUpDegree;
+  f->avgDegree = (n > 0) ? (double)graph->numEdges / (double)n : 0.0;
+  f->skew = (f->avgDegree > 0.0) ? (double)maxDegree / f->avgDegree : 0.0;
+  f->density = (n > 1) ? (double)f->m / (0.5 * (double)n * ((double)n - 1.0)) : 0.0;
+  f->k = horizontal_fraction(graph);
+  f->wedges = wedges;
+  f->sumSquares = sumSquares;
+  f->forwardWork = forwardWork;
+  f->forwardDegreeWork = forwardDegreeWork;
+}
+
+/* Cheap features of a graph, O(n + m) */
+void graph_features(const GRAPH_TYPE *graph, graphFeatures_t *f) {
+  features(graph, f, false);
+}
+
+static double candidate_work(const autoCandidate_t *c, const graphFeatures_t *f) {
+  switch (c->work) {
+  case WORK_SUM_SQUARES:    return f->sumSquares;
+  case WORK_FORWARD:        return f->forwardWork;
+  case WORK_FORWARD_DEGREE: return f->forwardDegreeWork;
+  case WORK_BADER:          return f->k * f->sumSquares;
+  }
+  return 0.0;
+}
+
+static double predict(const autoCandidate_t *c, const graphFeatures_t *f) {
+  return c->alpha * candidate_work(c, f) + c->beta * ((double)f->n + 2.0 * (double)f->m);
+}
+
+/* tc_MapJIK_P gives up (and counts 0) when its hash map, sized from the
+   longest upper adjacency list in increasing degree order, has more
+   slots than the graph has vertices. The list of v is at most the
+   neighbors of no smaller degree, whatever the ties. */
+static bool candidate_runs(const autoCandidate_t *c, const graphFeatures_t *f) {
+#ifdef PARALLEL
+  if (c->f == tc_MapJIK_P) {
+    int l2;
+    for (l2 = 1 ; (double)f->maxUpDegree + 1.0 > (double)(1 << l2) ; l2++);
+    return (double)f->n >= (double)((1 << (l2 + 4)) - 1);
+  }
+#else
+  (void)c; (void)f;
+#endif
+  return true;
+}
+
+/* Candidates that cannot run, or that miscounted during calibration
+   (infinite alpha), are not chosen; the first candidate of the kind is
+   the fallback if none is left */
+static int auto_select(const graphFeatures_t *f, const bool parallel) {
+  int first = -1, best = -1;
+  double bestTime = 0.0;
+
+  for (int c = 0 ; c < numCandidates ; c++) {
+    if (candidates[c].parallel != parallel) continue;
+    if (first < 0) first = c;
+    if (!candidate_runs(&candidates[c], f) || isinf(candidates[c].alpha)) continue;
+    const double t = predict(&candidates[c], f);
+    if ((best < 0) || (t < bestTime)) {
+      best = c;
+      bestTime = t;
+    }
+  }
+  return (best < 0) ? first : best;
+}
+
+UINT_t tc_auto(const GRAPH_TYPE *graph) {
+  graphFeatures_t f;
+
+  features(graph, &f, false);
+  PHASE(PHASE_PREPROCESS);
+  return (*candidates[auto_select(&f, false)].f)(graph);
+}
+
+#ifdef PARALLEL
+UINT_t tc_auto_P(const GRAPH_TYPE *graph) {
+  graphFeatures_t f;
+
+  features(graph, &f, true);
+  PHASE(PHASE_PREPROCESS);
+  return (*candidates[auto_select(&f, true)].f)(graph);
+}
+#endif
+
+static int find_candidate(const char *name) {
+  for (int c = 0 ; c < numCandidates ; c++)
+    if (strcmp(candidates[c].name, name) == 0)
+      return c;
+  return -1;
+}
+
+/* A profile has one "kernel alpha beta" line per candidate; # starts a
+   comment, and inf marks a candidate that miscounted. Kernels that are
+   not candidates of this build are ignored. */
+void auto_load_profile(const char *filename) {
+  char line[256], name[128];
+  double alpha, beta;
+  int lineNumber = 0;
+
+  FILE *fp = fopen(filename, "r");
+  if (fp == NULL) {
+    fprintf(stderr,"ERROR: Cannot open profile %s\n", filename);
+    exit(8);
+  }
+
+  while (fgets(line, sizeof(line), fp) != NULL) {
+    lineNumber++;
+    char *p = line + strspn(line, " \t");
+    if ((*p == '#') || (*p == '\n') || (*p == '\0'))
+      continue;
+    if ((sscanf(p, "%127s %lf %lf", name, &alpha, &beta) != 3) || (alpha < 0.0) || (beta < 0.0)) {
+      fprintf(stderr,"ERROR: %s:%d: expected a kernel name and two non-negative coefficients\n", filename, lineNumber);
+      exit(8);
+    }
+    const int c = find_candidate(name);
+    if (c < 0) continue;
+    candidates[c].alpha = alpha;
+    candidates[c].beta = beta;
+  }
+
+  fclose(fp);
+}
+
+/* The subgraph induced by keeping each vertex with probability p */
+static GRAPH_TYPE *induced_sample(const GRAPH_TYPE *graph, const double p, const uint64_t seed, const int sample) {
+  const UINT_t* restrict Ap = graph->rowPtr;
+  const VERTEX_t* restrict Ai = graph->colInd;
+  const UINT_t n = graph->numVertices;
+  const UINT_t NONE = n;
+  UINT_t newN = 0, newM = 0;
+
+  UINT_t *id = (UINT_t *)malloc(n * sizeof(UINT_t));
+  assert_malloc(id);
+  for (UINT_t v = 0 ; v < n ; v++)
+    id[v] = (random_uniform(seed, AUTO_STREAM + sample, v) < p) ? newN++ : NONE;
+
+  for (UINT_t v = 0 ; v < n ; v++)
+    if (id[v] != NONE)
+      for (UINT_t i = Ap[v] ; i < Ap[v+1] ; i++)
+	if (id[Ai[i]] != NONE) newM++;
+
+  GRAPH_TYPE *s = (GRAPH_TYPE *)malloc(sizeof(GRAPH_TYPE));
+  assert_malloc(s);
+  s->numVertices = newN;
+  s->numEdges = newM;
+  allocate_graph(s);
+
+  /* Relabeling keeps the order, so the adjacency lists stay sorted */
+  UINT_t e = 0;
+  for (UINT_t v = 0 ; v < n ; v++) {
+    if (id[v] == NONE) continue;
+    s->rowPtr[id[v]] = e;
+    for (UINT_t i = Ap[v] ; i < Ap[v+1] ; i++)
+      if (id[Ai[i]] != NONE)
+	s->colInd[e++] = id[Ai[i]];
+  }
+  s->rowPtr[newN] = e;
+
+  free(id);
+  return s;
+}
+
+/* Least squares fit of t = alpha * w + beta * z with alpha, beta >= 0 */
+static void fit(const double *w, const double *z, const double *t, const int samples, double *alpha, double *beta) {
+  double sww = 0.0, swz = 0.0, szz = 0.0, swt = 0.0, szt = 0.0;
+
+  for (int s = 0 ; s < samples ; s++) {
+    sww += w[s] * w[s];
+    swz += w[s] * z[s];
+    szz += z[s] * z[s];
+    swt += w[s] * t[s];
+    szt += z[s] * t[s];
+  }
+
+  const double det = sww * szz - swz * swz;
+  if (det > 1.0e-9 * sww * szz) {
+    *alpha = (swt * szz - szt * swz) / det;
+    *beta = (szt * sww - swt * swz) / det;
+    if ((*alpha >= 0.0) && (*beta >= 0.0))
+      return;
+  }
+  /* Degenerate or negative: one term only */
+  if (sww > 0.0) {
+    *alpha = swt / sww;
+    *beta = 0.0;
+  }
+  else {
+    *alpha = 0.0;
+    *beta = (szt > 0.0) ? szt / szz : 0.0;
+  }
+}
+
+/* Time every candidate of this build on AUTO_CALIBRATE_SAMPLES induced
+   subgraphs of the graph, each with half the edges of the previous one
+   and the first with at most AUTO_CALIBRATE_EDGES, fit alpha and beta
+   per candidate and write them to a profile. Parallel candidates run
+   with the current number of OpenMP threads. A candidate is fitted only
+   on the samples it can run on; one that miscounts any sample gets an
+   infinite cost, so that tc_auto never picks it. */
+void auto_calibrate(const GRAPH_TYPE *graph, const char *filename, const uint64_t seed, FILE *outfile) {
+  double work[numCandidates][AUTO_CALIBRATE_SAMPLES];
+  double size[numCandidates][AUTO_CALIBRATE_SAMPLES];
+  double time[numCandidates][AUTO_CALIBRATE_SAMPLES];
+  int fitted[numCandidates];       /* samples timed per candidate */
+  bool miscounted[numCandidates];
+  const double m = (double)(graph->numEdges / 2);
+  double p = (m > AUTO_CALIBRATE_EDGES) ? sqrt(AUTO_CALIBRATE_EDGES / m) : 1.0;
+  int threads = 1;
+
+#ifdef PARALLEL
+  threads = omp_get_max_threads();
+#endif
+  for (int c = 0 ; c < numCandidates ; c++) {
+    fitted[c] = 0;
+    miscounted[c] = false;
+  }
+
+  for (int s = 0 ; s < AUTO_CALIBRATE_SAMPLES ; s++, p *= M_SQRT1_2) {
+    GRAPH_TYPE *sample = induced_sample(graph, p, seed, s);
+    graphFeatures_t f;
+    UINT_t reference = 0;
+
+    graph_features(sample, &f);
+    for (int c = 0 ; c < numCandidates ; c++) {
+      double best = 0.0;
+      UINT_t count = 0;
+      if ((c > 0) && !candidate_runs(&candidates[c], &f)) {
+	fprintf(outfile,"CALIBRATE\t%d\t%12" PRIUINT "\t%12" PRIUINT "\t%-30s\t%9s\n",
+		s, sample->numVertices, sample->numEdges / 2, candidates[c].name, "skipped");
+	continue;
+      }
+      for (int r = 0 ; r < AUTO_CALIBRATE_RUNS ; r++) {
+	const double t = get_seconds();
+	count = (*candidates[c].f)(sample);
+	const double elapsed = get_seconds() - t;
+	if ((r == 0) || (elapsed < best)) best = elapsed;
+      }
+      if (c == 0)
+	reference = count;
+      else if (count != reference) {
+	fprintf(stderr,"ERROR: %s counts %" PRIUINT " triangles on sample %d, %s counts %" PRIUINT "\n",
+		candidates[c].name, count, s, candidates[0].name, reference);
+	miscounted[c] = true;
+      }
+      work[c][fitted[c]] = candidate_work(&candidates[c], &f);
+      size[c][fitted[c]] = (double)sample->numVertices + (double)sample->numEdges;
+      time[c][fitted[c]] = best;
+      fitted[c]++;
+      fprintf(outfile,"CALIBRATE\t%d\t%12" PRIUINT "\t%12" PRIUINT "\t%-30s\t%9.6f\n",
+	      s, sample->numVertices, sample->numEdges / 2, candidates[c].name, best);
+      fflush(outfile);
+    }
+    free_graph(sample);
+  }
+
+  FILE *fp = fopen(filename, "w");
+  if (fp == NULL) {
+    fprintf(stderr,"ERROR: Cannot create profile %s\n", filename);
+    exit(8);
+  }
+  fprintf(fp,"# tc_auto profile: seconds = alpha * work + beta * (n + numEdges)\n");
+  fprintf(fp,"# calibrated on %d samples of a graph with %" PRIUINT " vertices and %" PRIUINT " edges, %d threads\n",
+	  AUTO_CALIBRATE_SAMPLES, graph->numVertices, graph->numEdges / 2, threads);
+  fprintf(fp,"# kernel                       alpha         beta\n");
+  for (int c = 0 ; c < numCandidates ; c++) {
+    if (miscounted[c]) {
+      candidates[c].alpha = INFINITY;
+      candidates[c].beta = INFINITY;
+    }
+    else if (fitted[c] > 0)
+      fit(work[c], size[c], time[c], fitted[c], &candidates[c].alpha, &candidates[c].beta);
+    else
+      fprintf(fp,"# %s could not run on any sample, built-in coefficients\n", candidates[c].name);
+    fprintf(fp,"%-30s %.6e %.6e\n", candidates[c].name, candidates[c].alpha, candidates[c].beta);
+  }
+  fclose(fp);
+
+  if (!QUIET)
+    fprintf(outfile,"Profile written to %s\n", filename);
+}
+
+/* The features of the graph and the predicted time of every candidate,
+   with the choices of tc_auto and tc_auto_P marked */
+void auto_print(const GRAPH_TYPE *graph, FILE *outfile) {
+  graphFeatures_t f;
+
+  graph_features(graph, &f);
+  fprintf(outfile,"AUTO features: max degree %" PRIUINT ", avg degree %.2f, skew %.1f, density %.3e, k %.4f, wedges %.3e\n",
+	  f.maxDegree, f.avgDegree, f.skew, f.density, f.k, f.wedges);
+
+  const int serial = auto_select(&f, false);
+#ifdef PARALLEL
+  const int parallel = auto_select(&f, true);
+#else
+  const int parallel = -1;
+#endif
+  for (int c = 0 ; c < numCandidates ; c++)
+    fprintf(outfile,"AUTO\t%-30s\t%9.6f%s\n", candidates[c].name, predict(&candidates[c], &f),
+	    ((c == serial) || (c == parallel)) ? "\t*" : (candidate_runs(&candidates[c], &f) ? "" : "\tcannot run"));
+}
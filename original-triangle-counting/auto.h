@@ -0,0 +1,42 @@
+#ifndef _AUTO_H
+#define _AUTO_H
+
+/* Automatic kernel selection. tc_auto (tc_auto_P) computes cheap
+   features of the graph, predicts the time of each candidate kernel as
+
+     seconds = alpha * work + beta * (n + numEdges)
+
+   where work is the candidate's operation count estimated from the
+   features, and runs the cheapest one. alpha and beta come from a
+   profile written by auto_calibrate (--calibrate) or from the built-in
+   defaults. */
+typedef struct {
+  UINT_t n;
+  UINT_t m;                   /* undirected edges */
+  UINT_t maxDegree;
+  UINT_t maxUpDegree;         /* most neighbors of no smaller degree */
+  double avgDegree;
+  double skew;                /* maxDegree / avgDegree */
+  double density;             /* m / (n (n-1) / 2) */
+  double k;                   /* fraction of horizontal edges of a BFS */
+  double wedges;              /* sum of d(d-1)/2 */
+  double sumSquares;          /* sum of d^2: intersections of every edge */
+  double forwardWork;         /* forward intersections in vertex order */
+  double forwardDegreeWork;   /* forward intersections in degree order */
+} graphFeatures_t;
+
+#define AUTO_CALIBRATE_EDGES    (1 << 22)   /* largest sample, undirected edges */
+#define AUTO_CALIBRATE_SAMPLES  3           /* samples, each half the size of the previous */
+#define AUTO_CALIBRATE_RUNS     3           /* best of, per candidate and sample */
+
+void graph_features(const GRAPH_TYPE *, graphFeatures_t *);
+void auto_load_profile(const char *);
+void auto_calibrate(const GRAPH_TYPE *, const char *, const uint64_t, FILE *);
+void auto_print(const GRAPH_TYPE *, FILE *);
+
+UINT_t tc_auto(const GRAPH_TYPE *);
+#ifdef PARALLEL
+UINT_t tc_auto_P(const GRAPH_TYPE *);
+#endif
+
+#endif
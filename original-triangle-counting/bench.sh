@@ -0,0 +1,140 @@
+#!/bin/bash
+# Regression benchmark: runs a fixed corpus of seeded generated graphs
+# through a set of kernels, writes the median times and compares them
+# with a baseline from an earlier run (make bench, make bench-baseline).
+#
+# Usage: bench.sh [-u] [-b baseline] [-o results] <tc binary>
+#   -u  save the results as the new baseline instead of comparing
+#
+# Environment:
+#   BENCH_SIZES      corpus sizes (default "small medium")
+#   BENCH_KERNELS    kernels, as for tc -a
+#   BENCH_LOOPS      timed runs per kernel (default 7)
+#   BENCH_THREADS    threads for the parallel kernels (default all)
+#   BENCH_THRESHOLD  smallest relative slowdown reported (default 0.10)
+#
+# A kernel has regressed when its median is slower than the baseline by
+# more than BENCH_THRESHOLD and by more than the combined 95% confidence
+# intervals of the two runs, so that a noisy kernel needs a larger
+# slowdown. The exit status is 1 for any regression or wrong count.
+
+BASELINE=bench_baseline.tsv
+RESULTS=bench_results.tsv
+UPDATE=0
+
+while getopts "ub:o:" opt; do
+  case $opt in
+    u) UPDATE=1 ;;
+    b) BASELINE=$OPTARG ;;
+    o) RESULTS=$OPTARG ;;
+    *) echo "Usage: $0 [-u] [-b baseline] [-o results] <tc binary>" >&2; exit 2 ;;
+  esac
+done
+shift $((OPTIND - 1))
+
+TC=$1
+if [ -z "$TC" ] || [ ! -x "$TC" ]; then
+  echo "ERROR: No tc binary given or $TC is not executable" >&2
+  exit 2
+fi
+
+SIZES=${BENCH_SIZES:-"small medium"}
+KERNELS=${BENCH_KERNELS:-"tc_intersect_MergePath,tc_intersect_Hash,tc_forward,tc_forward_hash,tc_forward_hash_degreeOrder,tc_compact_forward,tc_davis,tc_bader,tc_bader4,tc_bader_forward_hash,tc_bader_new_bfs,tc_treelist2,tc_bader_bfs1_P,tc_forward_hash_P"}
+LOOPS=${BENCH_LOOPS:-7}
+THRESHOLD=${BENCH_THRESHOLD:-0.10}
+SEED=1
+
+# The corpus. Changing a graph changes its hash, and its kernels are
+# then reported as new instead of being compared.
+corpus() {
+  case $1 in
+    small)
+      echo "-r 12"
+      echo "-g er:4096,65536"
+      echo "-g chunglu:4096,16,2.5"
+      echo "-g ba:4096,8"
+      echo "-g rgg:4096,0.04" ;;
+    medium)
+      echo "-r 15"
+      echo "-g er:32768,524288"
+      echo "-g chunglu:32768,16,2.5"
+      echo "-g ba:32768,8"
+      echo "-g rgg:32768,0.014" ;;
+    large)
+      echo "-r 18"
+      echo "-g er:262144,4194304"
+      echo "-g chunglu:262144,16,2.5"
+      echo "-g ba:262144,8"
+      echo "-g rgg:262144,0.005" ;;
+    *)
+      echo "ERROR: Unknown corpus size $1 (small, medium, large)" >&2
+      exit 2 ;;
+  esac
+}
+
+THREADS_OPT=
+if [ -n "$BENCH_THREADS" ]; then
+  THREADS_OPT="-p $BENCH_THREADS"
+fi
+
+JSON=$(mktemp)
+trap 'rm -f "$JSON"' EXIT
+
+for size in $SIZES; do
+  corpus $size > /dev/null || exit 2
+  corpus $size | while read -r graph; do
+    echo "bench: $size $graph" >&2
+    $TC $graph -s $SEED -q -x -L $LOOPS -a $KERNELS $THREADS_OPT -O "$JSON" > /dev/null || exit 2
+  done || exit 2
+done
+
+# One line per graph, kernel and thread count:
+#   graph hash kernel threads triangles correct median ci95
+printf "# graph\thash\tkernel\tthreads\ttriangles\tcorrect\tmedian\tci95\n" > "$RESULTS"
+sed -n 's/^{"graph":"\([^"]*\)".*"hash":"\([^"]*\)","kernel":"\([^"]*\)".*"threads":\([0-9]*\),"triangles":\([0-9]*\),"correct":\([a-z]*\).*"median":\([^,]*\),"mean":[^,]*,"stddev":[^,]*,"ci95":\([^,]*\),.*/\1\t\2\t\3\t\4\t\5\t\6\t\7\t\8/p' \
+    "$JSON" >> "$RESULTS"
+echo "bench: results in $RESULTS" >&2
+
+if [ $UPDATE -eq 1 ]; then
+  cp "$RESULTS" "$BASELINE"
+  echo "bench: saved as baseline $BASELINE" >&2
+  exit 0
+fi
+
+if [ ! -f "$BASELINE" ]; then
+  echo "ERROR: No baseline $BASELINE, create one with make bench-baseline" >&2
+  exit 2
+fi
+
+awk -F'\t' -v threshold="$THRESHOLD" '
+  /^#/ { next }
+  FNR == NR { key = $1 FS $2 FS $3 FS $4; median[key] = $7; ci[key] = $8; next }
+  {
+    key = $1 FS $2 FS $3 FS $4
+    if ($6 != "true") {
+      status = "WRONG"; failed++
+    }
+    else if (!(key in median)) {
+      status = "new"
+    }
+    else {
+      base = median[key]
+      noise = sqrt(ci[key] * ci[key] + $8 * $8)
+      change = (base > 0) ? ($7 - base) / base : 0
+      if ((change > threshold) && ($7 - base > noise)) {
+        status = "REGRESSION"; failed++
+      }
+      else if ((change < -threshold) && (base - $7 > noise))
+        status = "faster"
+      else
+        status = "ok"
+    }
+    if (status == "new" || status == "WRONG")
+      printf("BENCH\t%s\t%-30s\t%3d\t%12s\t%12.6f\t%8s\t%s\n", $1, $3, $4, "", $7, "", status)
+    else
+      printf("BENCH\t%s\t%-30s\t%3d\t%12.6f\t%12.6f\t%+7.1f%%\t%s\n", $1, $3, $4, base, $7, 100 * change, status)
+  }
+  END {
+    if (failed) { printf("bench: %d kernel(s) regressed or miscounted\n", failed); exit 1 }
+    print "bench: no regressions"
+  }' "$BASELINE" "$RESULTS"
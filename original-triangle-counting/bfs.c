@@ -105,7 +105,7 @@ void bfs_visited_P_DEBUG(const GRAPH_TYPE *graph, const UINT_t startVertex, UINT
   UINT_t totalenq;
   UINT_t totaldeq;
 
-  printf("BFS_Visited_P (%d):\n",startVertex);
+  printf("BFS_Visited_P (%" PRIUINT "):\n",startVertex);
 
   int *vstate = (int *)calloc(graph->numVertices, sizeof(int));
   assert_malloc(vstate);
@@ -114,7 +114,7 @@ void bfs_visited_P_DEBUG(const GRAPH_TYPE *graph, const UINT_t startVertex, UINT
 
   visited[startVertex] = true;
   enqueue(queue, startVertex);
-  if (vstate[startVertex] != 0) printf("T%2d: ERROR: ENQ %3d\n",omp_get_thread_num(), startVertex);
+  if (vstate[startVertex] != 0) printf("T%2d: ERROR: ENQ %3" PRIUINT "\n",omp_get_thread_num(), startVertex);
   vstate[startVertex] = 1;
   qsize = 1;
   totalenq = 1;
@@ -130,8 +130,8 @@ void bfs_visited_P_DEBUG(const GRAPH_TYPE *graph, const UINT_t startVertex, UINT
       omp_set_lock(&qlock);
       if (!isEmpty(queue)) {
 	v = dequeue(queue);
-	printf("T%2d: DEQ %d\n",omp_get_thread_num(), v);
-	if (vstate[v] != 1) printf("T%2d: ERROR: DEQ %3d\n",omp_get_thread_num(), v);
+	printf("T%2d: DEQ %" PRIUINT "\n",omp_get_thread_num(), v);
+	if (vstate[v] != 1) printf("T%2d: ERROR: DEQ %3" PRIUINT "\n",omp_get_thread_num(), v);
 	vstate[v] = 2;
 	qsize--;
 	totaldeq++;
@@ -148,15 +148,15 @@ void bfs_visited_P_DEBUG(const GRAPH_TYPE *graph, const UINT_t startVertex, UINT
 	  /* omp_set_lock(&qlock); */
 	  if (!visited[w]) {
 	    visited[w] = true;
-	    printf("T%2d: ENQ %d\n",omp_get_thread_num(), w);
-	    if (vstate[w] != 0) printf("T%2d: ERROR: ENQ %3d\n",omp_get_thread_num(), w);
+	    printf("T%2d: ENQ %" PRIUINT "\n",omp_get_thread_num(), w);
+	    if (vstate[w] != 0) printf("T%2d: ERROR: ENQ %3" PRIUINT "\n",omp_get_thread_num(), w);
 	    vstate[w] = 1;
 	    enqueue(queue, w);
 	    qsize++;
 	    totalenq++;
 	    
 	    level[w] = level[v] + 1;
-	    printf("T%2d: Level[%3d] <-- %3d  treeedge: (%3d, %3d) \n",omp_get_thread_num(), w, level[w],v, w);
+	    printf("T%2d: Level[%3" PRIUINT "] <-- %3" PRIUINT "  treeedge: (%3" PRIUINT ", %3" PRIUINT ") \n",omp_get_thread_num(), w, level[w],v, w);
 	  }
 	  /* omp_unset_lock(&qlock); */
 	}
@@ -168,7 +168,7 @@ void bfs_visited_P_DEBUG(const GRAPH_TYPE *graph, const UINT_t startVertex, UINT
     #pragma omp barrier
   }
 
-  printf("q empty: %d  qsize: %d  total enq: %d total deq: %d  n: %d\n",isEmpty(queue)?1:0, qsize, totalenq, totaldeq, graph->numVertices);
+  printf("q empty: %d  qsize: %" PRIUINT "  total enq: %" PRIUINT " total deq: %" PRIUINT "  n: %" PRIUINT "\n",isEmpty(queue)?1:0, qsize, totalenq, totaldeq, graph->numVertices);
 
 
   /* CHECK */
@@ -184,7 +184,7 @@ void bfs_visited_P_DEBUG(const GRAPH_TYPE *graph, const UINT_t startVertex, UINT
   for (int i=0 ; i<graph->numVertices; i++) {
     if (checkVisited[i]) {
       if (level[i] != checkLevel[i])
-	printf("ERROR: Level[%3d]: %3d (not %3d)\n",i, level[i], checkLevel[i]);
+	printf("ERROR: Level[%3d]: %3" PRIUINT " (not %3" PRIUINT ")\n",i, level[i], checkLevel[i]);
     }
   }
 
@@ -201,7 +201,7 @@ void bfs_visited_P_DEBUG(const GRAPH_TYPE *graph, const UINT_t startVertex, UINT
 
 void bfs_mark_horizontal_edges(const GRAPH_TYPE *graph, const UINT_t startVertex, UINT_t* restrict level, Queue* queue, bool* visited, bool* horiz) {
   const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
+  const VERTEX_t *restrict Ai = graph->colInd;
 
   visited[startVertex] = true;
   enqueue(queue, startVertex);
@@ -242,7 +242,7 @@ void top_down_step(UINT_t* frontier, UINT_t* next, bool* visited, const GRAPH_TY
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
   UINT_t* Ap = graph->rowPtr;
-  UINT_t* Ai = graph->colInd;
+  VERTEX_t* Ai = graph->colInd;
 
   UINT_t next_size = 0; // track number of elements in the next array
   for (UINT_t i = 0; i < frontier_size; i++) {
@@ -277,7 +277,7 @@ void bottom_up_step(UINT_t* frontier, UINT_t* next, bool *visited, const GRAPH_T
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
   UINT_t* Ap = graph->rowPtr;
-  UINT_t* Ai = graph->colInd;
+  VERTEX_t* Ai = graph->colInd;
 
   UINT_t next_size = 0;
   for (UINT_t i = 0; i < frontier_size; i++) {
@@ -316,7 +316,7 @@ void bfs_hybrid_visited(const GRAPH_TYPE* graph, const UINT_t startVertex, UINT_
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
   UINT_t* Ap = graph->rowPtr;
-  UINT_t* Ai = graph->colInd;
+  VERTEX_t* Ai = graph->colInd;
 
   UINT_t* frontier = (UINT_t*)malloc(n * sizeof(UINT_t));
   assert_malloc(frontier);
@@ -383,7 +383,7 @@ void top_down_step_P(UINT_t* frontier, UINT_t* next, bool* visited, const GRAPH_
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
   UINT_t* Ap = graph->rowPtr;
-  UINT_t* Ai = graph->colInd;
+  VERTEX_t* Ai = graph->colInd;
 
   UINT_t next_size = 0; // track number of elements in the next array
 #pragma omp for schedule(dynamic)
@@ -405,7 +405,7 @@ void bottom_up_step_P(UINT_t* frontier, UINT_t* next, bool *visited, const GRAPH
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
   UINT_t* Ap = graph->rowPtr;
-  UINT_t* Ai = graph->colInd;
+  VERTEX_t* Ai = graph->colInd;
 
   UINT_t next_size = 0;
 #pragma omp for schedule(dynamic)
@@ -430,7 +430,7 @@ void bfs_hybrid_visited_P(const GRAPH_TYPE* graph, const UINT_t startVertex, UIN
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
   UINT_t* Ap = graph->rowPtr;
-  UINT_t* Ai = graph->colInd;
+  VERTEX_t* Ai = graph->colInd;
 
   UINT_t* frontier = (UINT_t*)malloc(n * sizeof(UINT_t));
   assert_malloc(frontier);
@@ -497,7 +497,7 @@ void bfs_chatgpt_P(const GRAPH_TYPE* graph, const UINT_t startVertex, UINT_t* le
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
   UINT_t* Ap = graph->rowPtr;
-  UINT_t* Ai = graph->colInd;
+  VERTEX_t* Ai = graph->colInd;
 
   visited[startVertex] = true;
 
@@ -538,7 +538,7 @@ void bfs_chatgpt_P(const GRAPH_TYPE* graph, const UINT_t startVertex, UINT_t* le
 #pragma omp critical
 	    {
 	      if (current_level_size >= n)
-		printf("ERROR: current_level_size: %d  n: %d\n",current_level_size,n);
+		printf("ERROR: current_level_size: %" PRIUINT "  n: %" PRIUINT "\n",current_level_size,n);
 	      current_level_vertices[current_level_size++] = w;
 	    }
 	  }
@@ -564,7 +564,7 @@ void bfs_locks_P(const GRAPH_TYPE* graph, const UINT_t startVertex, UINT_t* leve
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
   UINT_t* Ap = graph->rowPtr;
-  UINT_t* Ai = graph->colInd;
+  VERTEX_t* Ai = graph->colInd;
 
   visited[startVertex] = true;
 
@@ -605,7 +605,7 @@ void bfs_locks_P(const GRAPH_TYPE* graph, const UINT_t startVertex, UINT_t* leve
 #pragma omp critical
 	    {
 	      if (current_level_size >= n)
-		printf("ERROR: current_level_size: %d  n: %d\n",current_level_size,n);
+		printf("ERROR: current_level_size: %" PRIUINT "  n: %" PRIUINT "\n",current_level_size,n);
 	      current_level_vertices[current_level_size++] = w;
 	    }
 	  }
@@ -706,7 +706,7 @@ UINT_t BUStep(const GRAPH_TYPE *graph, INT_t *parent, bool *visited, bool *front
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
   UINT_t* Ap = graph->rowPtr;
-  UINT_t* Ai = graph->colInd;
+  VERTEX_t* Ai = graph->colInd;
 
   UINT_t awake_count = 0;
   for (UINT_t i=0 ; i<n ; i++)
@@ -736,7 +736,7 @@ UINT_t TDStep(const GRAPH_TYPE *graph, INT_t *parent, bool *visited, SlidingQueu
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
   UINT_t* Ap = graph->rowPtr;
-  UINT_t* Ai = graph->colInd;
+  VERTEX_t* Ai = graph->colInd;
 
   UINT_t scout_count = 0;
 #pragma omp parallel
@@ -811,7 +811,7 @@ void bfs_beamerGAP_P(const GRAPH_TYPE* graph, const UINT_t startVertex, UINT_t*
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
   UINT_t* Ap = graph->rowPtr;
-  UINT_t* Ai = graph->colInd;
+  VERTEX_t* Ai = graph->colInd;
 
   UINT_t alpha = BEAMERGAP_ALPHA;
   UINT_t beta = BEAMERGAP_BETA;
@@ -826,7 +826,7 @@ void bfs_beamerGAP_P(const GRAPH_TYPE* graph, const UINT_t startVertex, UINT_t*
   INT_t *parent = (INT_t *)malloc(n * sizeof(INT_t));
   assert_malloc(parent);
 
-  printf("here 1 startVertex: %d\n",startVertex);
+  printf("here 1 startVertex: %" PRIUINT "\n",startVertex);
 
 #pragma omp parallel for
   for (UINT_t i=0 ; i<n ; i++) {
@@ -0,0 +1,637 @@
+#include "types.h"
+#include "graph.h"
+#include "sort.h"
+#include "gen.h"
+#ifdef PARALLEL
+#include <omp.h>
+#endif
+
+static int gen_num_threads(void) {
+#ifdef PARALLEL
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+static int gen_thread_num(void) {
+#ifdef PARALLEL
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+/* Sort the packed keys of both directions of every edge, drop the
+   duplicates and build the CSR graph. Frees keys. */
+static void keys_to_graph(GRAPH_TYPE* graph, const uint64_t n, uint64_t* keys, const size_t edgeCount, const int shift) {
+  uint64_t* keysNoDup = (uint64_t*)malloc((edgeCount + 1) * sizeof(uint64_t));
+  assert_malloc(keysNoDup);
+
+  radix_sort_u64(keys, keysNoDup, edgeCount, 2*shift);
+  const UINT_t edgeCountNoDup = unique_u64(keys, keysNoDup, edgeCount);
+  free(keys);
+
+  graph->numVertices = n;
+  graph->numEdges = edgeCountNoDup;
+  allocate_graph(graph);
+  convert_edges_to_graph(keysNoDup, shift, true, graph);
+  free(keysNoDup);
+}
+
+/* A seeded bijection on [0, 2^scale): odd multiplies and xor-shifts are
+   both invertible modulo 2^scale. */
+static INLINE VERTEX_t scramble_vertex(uint64_t v, const int scale, const uint64_t k0, const uint64_t k1) {
+  const uint64_t mask = (((uint64_t)1) << scale) - 1;
+  const int s = max(1, scale / 2);
+  v = (v * 0x9E3779B97F4A7C15ULL + k0) & mask;
+  v ^= v >> s;
+  v = (v * 0xBF58476D1CE4E5B9ULL + k1) & mask;
+  v ^= v >> s;
+  return (VERTEX_t)v;
+}
+
+/* Graph500 Kronecker generator. Each of the 2^scale * edgeFactor edges
+   descends scale levels of the recursive adjacency matrix, picking a
+   quadrant with probability a, b, c or d at each level; edge e draws its
+   random numbers from stream e, two levels per 64-bit value. Both
+   directions of every edge are packed into keys, and self-loops and
+   duplicates are removed by sorting, so the graph has at most
+   2 * 2^scale * edgeFactor directed edges. */
+void create_graph_RMAT(GRAPH_TYPE* graph, const int scale, const int edgeFactor, const rmatParams_t* params) {
+  const uint64_t n = (uint64_t)1 << scale;
+  const uint64_t numGen = n * edgeFactor;
+  const int numThreads = gen_num_threads();
+  const uint64_t blockSize = (numGen + numThreads - 1) / numThreads;
+
+  if ((scale > 31) || (n - 1 > (uint64_t)(VERTEX_t)(~0)) || (2 * numGen > (uint64_t)(UINT_t)(~0))) {
+    fprintf(stderr,"ERROR: RMAT graph of scale %d is too large for this build (see WIDE in the Makefile)\n", scale);
+    exit(8);
+  }
+
+  /* Quadrant thresholds on 32-bit random numbers */
+  const uint64_t tA   = (uint64_t)(params->a * 4294967296.0);
+  const uint64_t tAB  = (uint64_t)((params->a + params->b) * 4294967296.0);
+  const uint64_t tABC = (uint64_t)((params->a + params->b + params->c) * 4294967296.0);
+  const uint64_t k0 = random_u64(params->seed, ~0ULL, 0);
+  const uint64_t k1 = random_u64(params->seed, ~0ULL, 1);
+  const int shift = edge_key_shift(n);
+
+  double gen_time = get_seconds();
+
+  uint64_t* keys = (uint64_t*)malloc((2*numGen + 1) * sizeof(uint64_t));
+  assert_malloc(keys);
+  uint64_t* blockEdges = (uint64_t*)calloc(numThreads, sizeof(uint64_t));
+  assert_malloc(blockEdges);
+
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static,1) num_threads(numThreads)
+#endif
+  for (int t = 0 ; t < numThreads ; t++) {
+    const uint64_t lo = min(numGen, t * blockSize);
+    const uint64_t hi = min(numGen, lo + blockSize);
+    uint64_t* out = keys + 2*lo;
+    uint64_t k = 0;
+    for (uint64_t e = lo ; e < hi ; e++) {
+      VERTEX_t src = 0, dst = 0;
+      uint64_t r = 0;
+      for (int level = 0 ; level < scale ; level++) {
+	if ((level & 1) == 0)
+	  r = random_u64(params->seed, e, level >> 1);
+	const uint64_t r32 = r & 0xFFFFFFFFULL;
+	r >>= 32;
+	if (r32 < tA)
+	  continue;
+	else if (r32 < tAB)
+	  dst |= (VERTEX_t)1 << level;
+	else if (r32 < tABC)
+	  src |= (VERTEX_t)1 << level;
+	else {
+	  src |= (VERTEX_t)1 << level;
+	  dst |= (VERTEX_t)1 << level;
+	}
+      }
+      if (params->permute) {
+	src = scramble_vertex(src, scale, k0, k1);
+	dst = scramble_vertex(dst, scale, k0, k1);
+      }
+      /* Do not keep self-loops */
+      if (src == dst) continue;
+      out[k++] = EDGE_KEY(src, dst, shift);
+      out[k++] = EDGE_KEY(dst, src, shift);
+    }
+    blockEdges[t] = k;
+  }
+
+  /* Close the gaps left by self-loops */
+  uint64_t edgeCount = 0;
+  for (int t = 0 ; t < numThreads ; t++) {
+    const uint64_t lo = min(numGen, t * blockSize);
+    if (edgeCount != 2*lo)
+      memmove(keys + edgeCount, keys + 2*lo, blockEdges[t] * sizeof(uint64_t));
+    edgeCount += blockEdges[t];
+  }
+  free(blockEdges);
+
+  keys_to_graph(graph, n, keys, edgeCount, shift);
+  const UINT_t edgeCountNoDup = graph->numEdges;
+
+  gen_time = get_seconds() - gen_time;
+
+  if (!QUIET)
+    printf("RMAT (scale %d, edge factor %d, a=%.3f b=%.3f c=%.3f d=%.3f, seed %lu%s): %lu edges generated, %" PRIUINT " kept, in %9.6f s (%d threads)\n",
+	   scale, edgeFactor, params->a, params->b, params->c, params->d, params->seed,
+	   params->permute ? ", permuted" : "", numGen, edgeCountNoDup / 2, gen_time, numThreads);
+}
+
+
+/* Generators of -g type:params. Every generator draws its random numbers
+   by (seed, stream, counter) from the index of the vertex or edge being
+   generated, so the graph does not depend on the number of threads.
+   Edges are collected in per-thread buffers as keys of both directions;
+   self-loops are skipped and duplicates removed when the graph is built. */
+#define GEN_CHUNK  1024
+
+typedef struct {
+  uint64_t *keys;
+  size_t count;
+  size_t capacity;
+} edgeBuffer_t;
+
+static INLINE void emit_edge(edgeBuffer_t *b, const uint64_t u, const uint64_t v, const int shift) {
+  if (u == v) return;
+  if (b->count + 2 > b->capacity) {
+    b->capacity = max(2 * b->capacity, (size_t)4096);
+    b->keys = (uint64_t *)realloc(b->keys, b->capacity * sizeof(uint64_t));
+    assert_malloc(b->keys);
+  }
+  b->keys[b->count++] = EDGE_KEY(u, v, shift);
+  b->keys[b->count++] = EDGE_KEY(v, u, shift);
+}
+
+static edgeBuffer_t *new_buffers(const int numThreads) {
+  edgeBuffer_t *buffers = (edgeBuffer_t *)calloc(numThreads, sizeof(edgeBuffer_t));
+  assert_malloc(buffers);
+  return buffers;
+}
+
+/* Concatenate the per-thread buffers, free them and build the graph */
+static void buffers_to_graph(GRAPH_TYPE* graph, const uint64_t n, edgeBuffer_t *buffers, const int numThreads, const int shift) {
+  size_t edgeCount = 0;
+  for (int t = 0 ; t < numThreads ; t++)
+    edgeCount += buffers[t].count;
+  if (edgeCount > (size_t)(UINT_t)(~0)) {
+    fprintf(stderr,"ERROR: Generated graph has too many edges for this build (see WIDE in the Makefile)\n");
+    exit(8);
+  }
+
+  uint64_t* keys = (uint64_t*)malloc((edgeCount + 1) * sizeof(uint64_t));
+  assert_malloc(keys);
+
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static,1) num_threads(numThreads)
+#endif
+  for (int t = 0 ; t < numThreads ; t++) {
+    size_t offset = 0;
+    for (int i = 0 ; i < t ; i++)
+      offset += buffers[i].count;
+    if (buffers[t].count > 0)
+      memcpy(keys + offset, buffers[t].keys, buffers[t].count * sizeof(uint64_t));
+    free(buffers[t].keys);
+  }
+  free(buffers);
+
+  keys_to_graph(graph, n, keys, edgeCount, shift);
+}
+
+static void check_size(const char *spec, const uint64_t n, const double edges) {
+  if ((n < 2) || (n - 1 > (uint64_t)(VERTEX_t)(~0)) || (n > ((uint64_t)1 << 32)) || (2.0 * edges > (double)(UINT_t)(~0))) {
+    fprintf(stderr,"ERROR: Graph %s is empty or too large for this build (see WIDE in the Makefile)\n", spec);
+    exit(8);
+  }
+}
+
+/* Sorted distinct keys, in a new array; frees keys */
+static uint64_t *sort_unique(uint64_t *keys, size_t *count, const int keyBits) {
+  uint64_t *out = (uint64_t *)malloc((*count + 1) * sizeof(uint64_t));
+  assert_malloc(out);
+  radix_sort_u64(keys, out, *count, keyBits);
+  *count = unique_u64(keys, out, *count);
+  free(keys);
+  return out;
+}
+
+/* Erdos-Renyi G(n,m): m distinct edges, uniform over all vertex pairs.
+   Rounds of uniform draws are made until there are m distinct edges, and
+   the surplus of the last round is dropped by a random priority. */
+static void gen_erdos_renyi(GRAPH_TYPE* graph, const char *spec, const uint64_t n, const uint64_t m, const uint64_t seed, const int numThreads) {
+  const int shift = edge_key_shift(n);
+  uint64_t *edges = NULL;
+  size_t have = 0;
+
+  check_size(spec, n, (double)m);
+  if ((double)m > 0.5 * (double)n * (double)(n - 1)) {
+    fprintf(stderr,"ERROR: %s: G(n,m) has at most n(n-1)/2 edges\n", spec);
+    exit(8);
+  }
+
+  for (uint64_t round = 0 ; have < m ; round++) {
+    const size_t draws = (m - have) + (m - have) / 8 + 64;
+    uint64_t *more = (uint64_t *)malloc((have + draws + 1) * sizeof(uint64_t));
+    assert_malloc(more);
+    if (have > 0)
+      memcpy(more, edges, have * sizeof(uint64_t));
+    free(edges);
+    edges = more;
+
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static) num_threads(numThreads)
+#endif
+    for (size_t i = 0 ; i < draws ; i++) {
+      const uint64_t u = random_u64(seed, round, 2*i) % n;
+      const uint64_t v = (u + 1 + random_u64(seed, round, 2*i + 1) % (n - 1)) % n;
+      edges[have + i] = (u < v) ? EDGE_KEY(u, v, shift) : EDGE_KEY(v, u, shift);
+    }
+    have += draws;
+    edges = sort_unique(edges, &have, 2*shift);
+  }
+
+  if (have > m) {
+    const uint64_t k = random_u64(seed, ~0ULL, 0);
+    uint64_t *priority = (uint64_t *)malloc(have * sizeof(uint64_t));
+    assert_malloc(priority);
+    uint64_t *tmp = (uint64_t *)malloc(have * sizeof(uint64_t));
+    assert_malloc(tmp);
+    for (size_t i = 0 ; i < have ; i++)
+      priority[i] = random_mix64(edges[i] ^ k);
+    radix_sort_u64(priority, tmp, have, 64);
+    const uint64_t threshold = priority[m - 1];
+    size_t kept = 0;
+    for (size_t i = 0 ; i < have ; i++)
+      if ((random_mix64(edges[i] ^ k) <= threshold) && (kept < m))
+	edges[kept++] = edges[i];
+    have = kept;
+    free(tmp);
+    free(priority);
+  }
+
+  uint64_t *keys = (uint64_t *)malloc((2*have + 1) * sizeof(uint64_t));
+  assert_malloc(keys);
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static) num_threads(numThreads)
+#endif
+  for (size_t i = 0 ; i < have ; i++) {
+    const uint64_t u = EDGE_KEY_SRC(edges[i], shift);
+    const uint64_t v = EDGE_KEY_DST(edges[i], shift);
+    keys[2*i] = EDGE_KEY(u, v, shift);
+    keys[2*i + 1] = EDGE_KEY(v, u, shift);
+  }
+  free(edges);
+
+  keys_to_graph(graph, n, keys, 2*have, shift);
+}
+
+/* Chung-Lu: sum(w)/2 edges whose endpoints are drawn with probability
+   proportional to the expected degrees w */
+static void gen_chung_lu(GRAPH_TYPE* graph, const char *spec, const uint64_t n, const double *w, const uint64_t seed, const int numThreads) {
+  const int shift = edge_key_shift(n);
+
+  double *W = (double *)malloc((n + 1) * sizeof(double));
+  assert_malloc(W);
+  W[0] = 0.0;
+  for (uint64_t i = 0 ; i < n ; i++)
+    W[i+1] = W[i] + w[i];
+  const double total = W[n];
+  const uint64_t m = (uint64_t)(0.5 * total + 0.5);
+
+  check_size(spec, n, (double)m);
+  edgeBuffer_t *buffers = new_buffers(numThreads);
+
+#ifdef PARALLEL
+#pragma omp parallel for schedule(dynamic,GEN_CHUNK) num_threads(numThreads)
+#endif
+  for (uint64_t e = 0 ; e < m ; e++) {
+    uint64_t end[2];
+    for (int s = 0 ; s < 2 ; s++) {
+      /* The last i with W[i] <= x */
+      const double x = random_uniform(seed, s, e) * total;
+      uint64_t lo = 0, hi = n;
+      while (hi - lo > 1) {
+	const uint64_t mid = lo + (hi - lo) / 2;
+	if (W[mid] <= x) lo = mid; else hi = mid;
+      }
+      end[s] = lo;
+    }
+    emit_edge(&buffers[gen_thread_num()], end[0], end[1], shift);
+  }
+
+  free(W);
+  buffers_to_graph(graph, n, buffers, numThreads, shift);
+}
+
+/* Power-law expected degrees w_i ~ (i+1)^(-1/(gamma-1)) with the given
+   mean, capped at n-1 */
+static double *power_law_degrees(const char *spec, const uint64_t n, const double avgDegree, const double gamma) {
+  if ((gamma <= 2.0) || (avgDegree <= 0.0)) {
+    fprintf(stderr,"ERROR: %s: Chung-Lu needs gamma > 2 and a positive average degree\n", spec);
+    exit(8);
+  }
+  double *w = (double *)malloc(n * sizeof(double));
+  assert_malloc(w);
+  double sum = 0.0;
+  for (uint64_t i = 0 ; i < n ; i++) {
+    w[i] = pow((double)(i + 1), -1.0 / (gamma - 1.0));
+    sum += w[i];
+  }
+  const double scale = avgDegree * (double)n / sum;
+  for (uint64_t i = 0 ; i < n ; i++)
+    w[i] = min(w[i] * scale, (double)(n - 1));
+  return w;
+}
+
+/* Expected degrees from a file, one non-negative number per vertex */
+static double *read_degrees(const char *filename, uint64_t *n) {
+  FILE *fp = fopen(filename, "r");
+  if (fp == NULL) {
+    fprintf(stderr,"ERROR: Cannot open degree sequence %s\n", filename);
+    exit(8);
+  }
+  size_t capacity = 1024;
+  double *w = (double *)malloc(capacity * sizeof(double));
+  assert_malloc(w);
+  double d;
+  *n = 0;
+  while (fscanf(fp, "%lf", &d) == 1) {
+    if (d < 0.0) {
+      fprintf(stderr,"ERROR: %s: negative degree\n", filename);
+      exit(8);
+    }
+    if (*n == capacity) {
+      capacity *= 2;
+      w = (double *)realloc(w, capacity * sizeof(double));
+      assert_malloc(w);
+    }
+    w[(*n)++] = d;
+  }
+  if (!feof(fp)) {
+    fprintf(stderr,"ERROR: %s: expected one degree per vertex\n", filename);
+    exit(8);
+  }
+  fclose(fp);
+  return w;
+}
+
+/* Barabasi-Albert with k edges per vertex, as the Batagelj-Brandes edge
+   list M: M[2e] = e/k is the new vertex of edge e, and M[2e+1] copies
+   M[r] for a uniform r <= 2e, which is preferential attachment. An odd r
+   is itself a copy, so each edge follows its chain of copies down to an
+   even slot independently of every other edge. */
+static void gen_barabasi_albert(GRAPH_TYPE* graph, const char *spec, const uint64_t n, const uint64_t k, const uint64_t seed, const int numThreads) {
+  const int shift = edge_key_shift(n);
+  const uint64_t m = n * k;
+
+  check_size(spec, n, (double)m);
+  edgeBuffer_t *buffers = new_buffers(numThreads);
+
+#ifdef PARALLEL
+#pragma omp parallel for schedule(dynamic,GEN_CHUNK) num_threads(numThreads)
+#endif
+  for (uint64_t e = 0 ; e < m ; e++) {
+    uint64_t slot = 2*e + 1;
+    while (slot & 1)
+      slot = random_u64(seed, 0, slot) % slot;
+    emit_edge(&buffers[gen_thread_num()], e / k, (slot / 2) / k, shift);
+  }
+
+  buffers_to_graph(graph, n, buffers, numThreads, shift);
+}
+
+/* Edges (u, v) for v in [lo, hi), each with probability p, by geometric
+   skips */
+static INLINE void sample_range(edgeBuffer_t *b, const uint64_t u, const uint64_t lo, const uint64_t hi, const double p,
+				const uint64_t seed, const uint64_t stream, const int shift) {
+  if ((p <= 0.0) || (lo >= hi)) return;
+  if (p >= 1.0) {
+    for (uint64_t v = lo ; v < hi ; v++)
+      emit_edge(b, u, v, shift);
+    return;
+  }
+  const double logq = log(1.0 - p);
+  uint64_t v = lo;
+  for (uint64_t c = 0 ; ; c++) {
+    const double skip = floor(log(1.0 - random_uniform(seed, stream, c)) / logq);
+    if (skip >= (double)(hi - v)) break;
+    v += (uint64_t)skip;
+    emit_edge(b, u, v, shift);
+    if (++v >= hi) break;
+  }
+}
+
+/* Stochastic block model: equal blocks, an edge inside a block with
+   probability pin and between blocks with probability pout */
+static void gen_sbm(GRAPH_TYPE* graph, const char *spec, const uint64_t n, const uint64_t blocks, const double pin, const double pout,
+		    const uint64_t seed, const int numThreads) {
+  const int shift = edge_key_shift(n);
+
+  if ((blocks < 1) || (blocks > n) || (pin < 0.0) || (pin > 1.0) || (pout < 0.0) || (pout > 1.0)) {
+    fprintf(stderr,"ERROR: %s: needs 1 <= blocks <= n and probabilities in [0,1]\n", spec);
+    exit(8);
+  }
+  const uint64_t blockSize = (n + blocks - 1) / blocks;
+  check_size(spec, n, 0.5 * (double)n * ((double)blockSize * pin + (double)n * pout));
+  edgeBuffer_t *buffers = new_buffers(numThreads);
+
+#ifdef PARALLEL
+#pragma omp parallel for schedule(dynamic,GEN_CHUNK) num_threads(numThreads)
+#endif
+  for (uint64_t u = 0 ; u < n ; u++) {
+    edgeBuffer_t *b = &buffers[gen_thread_num()];
+    const uint64_t blockEnd = min(n, (u / blockSize + 1) * blockSize);
+    sample_range(b, u, u + 1, blockEnd, pin, seed, 2*u, shift);
+    sample_range(b, u, blockEnd, n, pout, seed, 2*u + 1, shift);
+  }
+
+  buffers_to_graph(graph, n, buffers, numThreads, shift);
+}
+
+/* 2D (z = 1) or 3D grid, each vertex joined to its axis neighbors */
+static void gen_grid(GRAPH_TYPE* graph, const char *spec, const uint64_t x, const uint64_t y, const uint64_t z, const int numThreads) {
+  const uint64_t n = x * y * z;
+  const int shift = edge_key_shift(n);
+
+  check_size(spec, n, 3.0 * (double)n);
+  edgeBuffer_t *buffers = new_buffers(numThreads);
+
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static) num_threads(numThreads)
+#endif
+  for (uint64_t v = 0 ; v < n ; v++) {
+    edgeBuffer_t *b = &buffers[gen_thread_num()];
+    if ((v % x) + 1 < x) emit_edge(b, v, v + 1, shift);
+    if (((v / x) % y) + 1 < y) emit_edge(b, v, v + x, shift);
+    if ((v / (x * y)) + 1 < z) emit_edge(b, v, v + x * y, shift);
+  }
+
+  buffers_to_graph(graph, n, buffers, numThreads, shift);
+}
+
+/* Random geometric graph: n uniform points in the unit square (dim 2) or
+   cube (dim 3), joined when closer than radius. Points are bucketed into
+   cells of side >= radius, so only neighboring cells are searched. */
+static void gen_geometric(GRAPH_TYPE* graph, const char *spec, const uint64_t n, const double radius, const int dim,
+			  const uint64_t seed, const int numThreads) {
+  const int shift = edge_key_shift(n);
+
+  if ((radius <= 0.0) || ((dim != 2) && (dim != 3))) {
+    fprintf(stderr,"ERROR: %s: needs a positive radius and dimension 2 or 3\n", spec);
+    exit(8);
+  }
+  check_size(spec, n, 0.5 * (double)n * (double)n * min(1.0, pow(2.0 * radius, dim)));
+
+  const uint64_t cellsPerDim = (uint64_t)max(1.0, min(floor(1.0 / radius), ceil(pow((double)n, 1.0 / dim))));
+  const uint64_t numCells = (dim == 2) ? cellsPerDim * cellsPerDim : cellsPerDim * cellsPerDim * cellsPerDim;
+
+  double *point = (double *)malloc(n * dim * sizeof(double));
+  assert_malloc(point);
+  uint64_t *cell = (uint64_t *)malloc(n * sizeof(uint64_t));
+  assert_malloc(cell);
+
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static) num_threads(numThreads)
+#endif
+  for (uint64_t i = 0 ; i < n ; i++) {
+    uint64_t c = 0;
+    for (int d = dim - 1 ; d >= 0 ; d--) {
+      point[i*dim + d] = random_uniform(seed, d, i);
+      c = c * cellsPerDim + min(cellsPerDim - 1, (uint64_t)(point[i*dim + d] * cellsPerDim));
+    }
+    cell[i] = c;
+  }
+
+  /* Counting sort of the points by cell */
+  uint64_t *cellStart = (uint64_t *)calloc(numCells + 1, sizeof(uint64_t));
+  assert_malloc(cellStart);
+  uint64_t *order = (uint64_t *)malloc(n * sizeof(uint64_t));
+  assert_malloc(order);
+  for (uint64_t i = 0 ; i < n ; i++)
+    cellStart[cell[i] + 1]++;
+  for (uint64_t c = 0 ; c < numCells ; c++)
+    cellStart[c + 1] += cellStart[c];
+  for (uint64_t i = 0 ; i < n ; i++)
+    order[cellStart[cell[i]]++] = i;
+  for (uint64_t c = numCells ; c > 0 ; c--)
+    cellStart[c] = cellStart[c - 1];
+  cellStart[0] = 0;
+
+  const double r2 = radius * radius;
+  edgeBuffer_t *buffers = new_buffers(numThreads);
+
+#ifdef PARALLEL
+#pragma omp parallel for schedule(dynamic,GEN_CHUNK) num_threads(numThreads)
+#endif
+  for (uint64_t u = 0 ; u < n ; u++) {
+    edgeBuffer_t *b = &buffers[gen_thread_num()];
+    int64_t cu[3] = { 0, 0, 0 };
+    uint64_t c = cell[u];
+    for (int d = 0 ; d < dim ; d++) {
+      cu[d] = (int64_t)(c % cellsPerDim);
+      c /= cellsPerDim;
+    }
+    for (int64_t dz = (dim == 3) ? -1 : 0 ; dz <= ((dim == 3) ? 1 : 0) ; dz++)
+      for (int64_t dy = -1 ; dy <= 1 ; dy++)
+	for (int64_t dx = -1 ; dx <= 1 ; dx++) {
+	  const int64_t nx = cu[0] + dx, ny = cu[1] + dy, nz = cu[2] + dz;
+	  if ((nx < 0) || (ny < 0) || (nz < 0) ||
+	      (nx >= (int64_t)cellsPerDim) || (ny >= (int64_t)cellsPerDim) || ((dim == 3) && (nz >= (int64_t)cellsPerDim)))
+	    continue;
+	  const uint64_t nc = (uint64_t)nx + cellsPerDim * ((uint64_t)ny + cellsPerDim * (uint64_t)nz);
+	  for (uint64_t j = cellStart[nc] ; j < cellStart[nc + 1] ; j++) {
+	    const uint64_t v = order[j];
+	    if (v <= u) continue;
+	    double dist2 = 0.0;
+	    for (int d = 0 ; d < dim ; d++) {
+	      const double delta = point[u*dim + d] - point[v*dim + d];
+	      dist2 += delta * delta;
+	    }
+	    if (dist2 <= r2)
+	      emit_edge(b, u, v, shift);
+	  }
+	}
+  }
+
+  free(order);
+  free(cellStart);
+  free(cell);
+  free(point);
+
+  buffers_to_graph(graph, n, buffers, numThreads, shift);
+}
+
+/* Comma separated numbers; returns how many, or -1 */
+static int parse_params(const char *s, double *p, const int maxParams) {
+  int np = 0;
+  while (*s) {
+    char *end;
+    if (np == maxParams) return -1;
+    p[np++] = strtod(s, &end);
+    if (end == s) return -1;
+    s = end;
+    if (*s == ',') s++;
+    else if (*s) return -1;
+  }
+  return np;
+}
+
+static void bad_spec(const char *spec) {
+  fprintf(stderr,"ERROR: Unknown graph generator %s, expected one of\n%s", spec, GEN_USAGE);
+  exit(8);
+}
+
+void create_graph_generator(GRAPH_TYPE* graph, const char *spec, const uint64_t seed) {
+  const int numThreads = gen_num_threads();
+  const char *colon = strchr(spec, ':');
+  double p[4];
+
+  if (colon == NULL) bad_spec(spec);
+  const size_t typeLen = colon - spec;
+  const char *params = colon + 1;
+#define GEN_TYPE(name)  ((typeLen == strlen(name)) && (strncmp(spec, name, typeLen) == 0))
+
+  double gen_time = get_seconds();
+
+  if (GEN_TYPE("chunglu") && (params[0] == '@')) {
+    uint64_t n;
+    double *w = read_degrees(params + 1, &n);
+    gen_chung_lu(graph, spec, n, w, seed, numThreads);
+    free(w);
+  }
+  else {
+    const int np = parse_params(params, p, 4);
+    if (GEN_TYPE("er") && (np == 2))
+      gen_erdos_renyi(graph, spec, (uint64_t)p[0], (uint64_t)p[1], seed, numThreads);
+    else if (GEN_TYPE("chunglu") && (np == 3)) {
+      const uint64_t n = (uint64_t)p[0];
+      check_size(spec, n, 0.0);
+      double *w = power_law_degrees(spec, n, p[1], p[2]);
+      gen_chung_lu(graph, spec, n, w, seed, numThreads);
+      free(w);
+    }
+    else if (GEN_TYPE("ba") && (np == 2) && (p[1] >= 1.0))
+      gen_barabasi_albert(graph, spec, (uint64_t)p[0], (uint64_t)p[1], seed, numThreads);
+    else if (GEN_TYPE("sbm") && (np == 4))
+      gen_sbm(graph, spec, (uint64_t)p[0], (uint64_t)p[1], p[2], p[3], seed, numThreads);
+    else if (GEN_TYPE("grid") && ((np == 2) || (np == 3)) && (p[0] >= 1.0) && (p[1] >= 1.0) && ((np == 2) || (p[2] >= 1.0)))
+      gen_grid(graph, spec, (uint64_t)p[0], (uint64_t)p[1], (np == 3) ? (uint64_t)p[2] : 1, numThreads);
+    else if (GEN_TYPE("rgg") && ((np == 2) || (np == 3)))
+      gen_geometric(graph, spec, (uint64_t)p[0], p[1], (np == 3) ? (int)p[2] : 2, seed, numThreads);
+    else
+      bad_spec(spec);
+  }
+#undef GEN_TYPE
+
+  gen_time = get_seconds() - gen_time;
+
+  if (!QUIET)
+    printf("Generated %s (seed %lu): %" PRIUINT " vertices, %" PRIUINT " edges, in %9.6f s (%d threads)\n",
+	   spec, seed, graph->numVertices, graph->numEdges / 2, gen_time, numThreads);
+}
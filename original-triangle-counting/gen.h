@@ -0,0 +1,48 @@
+#ifndef _GEN_H
+#define _GEN_H
+
+/* Counter-based random numbers: the value depends only on (seed, stream,
+   counter), so any thread can produce any part of a random sequence and
+   the generated graphs do not depend on the number of threads. */
+static INLINE uint64_t random_mix64(uint64_t z) {
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+static INLINE uint64_t random_u64(const uint64_t seed, const uint64_t stream, const uint64_t counter) {
+  return random_mix64(random_mix64(seed ^ (stream * 0x9E3779B97F4A7C15ULL)) + counter);
+}
+
+/* Uniform in [0,1) */
+static INLINE double random_uniform(const uint64_t seed, const uint64_t stream, const uint64_t counter) {
+  return (double)(random_u64(seed, stream, counter) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* Graph500 Kronecker (R-MAT) generator parameters */
+typedef struct {
+  double a, b, c, d;        /* quadrant probabilities, a + b + c + d = 1 */
+  uint64_t seed;
+  bool permute;             /* scramble the vertex IDs */
+} rmatParams_t;
+
+#define RMAT_DEFAULT_A     0.57
+#define RMAT_DEFAULT_B     0.19
+#define RMAT_DEFAULT_C     0.19
+#define RMAT_DEFAULT_SEED  1
+
+void create_graph_RMAT(GRAPH_TYPE*, const int, const int, const rmatParams_t*);
+
+/* Other generators, selected by a "type:params" string (-g) */
+#define GEN_USAGE \
+  "  er:n,m                  Erdos-Renyi G(n,m)\n" \
+  "  chunglu:n,avgdeg,gamma  Chung-Lu, power-law expected degrees (gamma > 2)\n" \
+  "  chunglu:@file           Chung-Lu, expected degrees read from file\n" \
+  "  ba:n,k                  Barabasi-Albert, k edges per new vertex\n" \
+  "  sbm:n,blocks,pin,pout   stochastic block model with equal blocks\n" \
+  "  grid:x,y[,z]            2D or 3D grid\n" \
+  "  rgg:n,radius[,dim]      random geometric graph in the unit square (dim 2) or cube (dim 3)\n"
+
+void create_graph_generator(GRAPH_TYPE*, const char *, const uint64_t);
+
+#endif
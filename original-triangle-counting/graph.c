@@ -1,5 +1,11 @@
 #include "types.h"
 #include "graph.h"
+#include "sort.h"
+#include "gen.h"
+#include "intersect.h"
+#include "hub.h"
+#include <sys/mman.h>
+#include <unistd.h>
 #ifdef PARALLEL
 #include "omp.h"
 #endif
@@ -9,13 +15,13 @@ void copy_graph(const GRAPH_TYPE *srcGraph, GRAPH_TYPE *dstGraph) {
   dstGraph->numVertices = srcGraph->numVertices;
   dstGraph->numEdges = srcGraph->numEdges;
   memcpy(dstGraph->rowPtr, srcGraph->rowPtr, (srcGraph->numVertices + 1) * sizeof(UINT_t));
-  memcpy(dstGraph->colInd, srcGraph->colInd, srcGraph->numEdges * sizeof(UINT_t));
+  memcpy(dstGraph->colInd, srcGraph->colInd, srcGraph->numEdges * sizeof(VERTEX_t));
 }
 
 void allocate_graph(GRAPH_TYPE* graph) {
   graph->rowPtr = (UINT_t*)calloc((graph->numVertices + 1), sizeof(UINT_t));
   assert_malloc(graph->rowPtr);
-  graph->colInd = (UINT_t*)calloc(graph->numEdges, sizeof(UINT_t));
+  graph->colInd = (VERTEX_t*)calloc(graph->numEdges, sizeof(VERTEX_t));
   assert_malloc(graph->colInd);
 }
 
@@ -25,148 +31,244 @@ void free_graph(GRAPH_TYPE* graph) {
     free(graph);
 }
 
-void allocate_graph_RMAT(const int scale, const int edgeFactor, GRAPH_TYPE* graph) {
-    graph->numVertices = 1 << scale;
-    graph->numEdges = 2 * graph->numVertices * edgeFactor; /* Factor of 2 is to store undirected edges (a, b) and (b, a) */
-
-    allocate_graph(graph);
-}
-
-
-static int compareInt_t(const void *a, const void *b) {
-    UINT_t arg1 = *(const UINT_t *)a;
-    UINT_t arg2 = *(const UINT_t *)b;
-    if (arg1 < arg2) return -1;
-    if (arg1 > arg2) return 1;
-    return 0;
+/* A mapped graph is a single private mapping holding the GRAPH_TYPE
+   header, rowPtr and colInd, each starting on a page boundary. */
+static size_t mapped_graph_layout(const UINT_t n, const UINT_t m, size_t* rowPtrOffset, size_t* colIndOffset) {
+  const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  *rowPtrOffset = (sizeof(GRAPH_TYPE) + page - 1) / page * page;
+  *colIndOffset = (*rowPtrOffset + (n + 1) * sizeof(UINT_t) + page - 1) / page * page;
+  return (*colIndOffset + m * sizeof(VERTEX_t) + page - 1) / page * page;
 }
 
-void convert_edges_to_graph(const edge_t* edges, GRAPH_TYPE* graph) {
-  const UINT_t n = graph->numVertices;
-  const UINT_t m = graph->numEdges;
-  UINT_t* Ap = graph->rowPtr;
-  UINT_t* Ai = graph->colInd;
-
-  for (UINT_t i = 0 ; i < n + 1 ; i++)
-    Ap[i] = 0;
-
-  // Count the number of edges incident to each vertex
-  for (UINT_t i = 0; i < m; i++) {
-    UINT_t vertex = edges[i].src;
-    Ap[vertex + 1]++;
+/* Map a graph with n vertices and m (directed) edges. Only the header page
+   is touched, so the caller decides where the pages of rowPtr and colInd
+   are placed. Release with free_protected_graph(). */
+GRAPH_TYPE *map_graph(const UINT_t n, const UINT_t m) {
+  size_t rowPtrOffset, colIndOffset;
+  const size_t len = mapped_graph_layout(n, m, &rowPtrOffset, &colIndOffset);
+
+  char *base = (char *)mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (base == (char *)MAP_FAILED) {
+    perror("mmap");
+    exit(1);
   }
 
-  // Compute the prefix sum of the rowPtr array
-  for (UINT_t i = 1; i <= n; i++) {
-    Ap[i] += Ap[i - 1];
-  }
+  GRAPH_TYPE *graph = (GRAPH_TYPE *)base;
+  graph->numVertices = n;
+  graph->numEdges = m;
+  graph->rowPtr = (UINT_t *)(base + rowPtrOffset);
+  graph->colInd = (VERTEX_t *)(base + colIndOffset);
+  return graph;
+}
 
-  // Populate the col_idx array with the destination vertices
-  UINT_t *current_row = (UINT_t *)calloc(n, sizeof(UINT_t));
-  assert_malloc(current_row);
-  for (UINT_t i = 0; i < m; i++) {
-    UINT_t src_vertex = edges[i].src;
-    UINT_t dst_vertex = edges[i].dst;
-    UINT_t index = Ap[src_vertex] + current_row[src_vertex];
-    Ai[index] = dst_vertex;
-    current_row[src_vertex]++;
-  }
+/* Make a mapped graph read-only. Kernels only get a const GRAPH_TYPE*, so
+   one that writes to its input anyway faults right away instead of
+   corrupting the runs that follow. */
+void readonly_graph(GRAPH_TYPE* graph) {
+  size_t rowPtrOffset, colIndOffset;
+  const size_t len = mapped_graph_layout(graph->numVertices, graph->numEdges, &rowPtrOffset, &colIndOffset);
 
-  // Sort the column indices within each row
-  for (UINT_t i = 0; i < graph->numVertices; i++) {
-    UINT_t s = Ap[i];
-    UINT_t e = Ap[i + 1];
-    UINT_t size = e - s;
-    UINT_t *row_indices = &Ai[s];
-    qsort(row_indices, size, sizeof(UINT_t), compareInt_t);
+  if (mprotect(graph, len, PROT_READ) != 0) {
+    perror("mprotect");
+    exit(1);
   }
+}
 
-  free(current_row);
+/* Return a read-only copy of graph */
+GRAPH_TYPE *protect_graph(const GRAPH_TYPE* graph) {
+  GRAPH_TYPE *graph2 = map_graph(graph->numVertices, graph->numEdges);
+  memcpy(graph2->rowPtr, graph->rowPtr, (graph->numVertices + 1) * sizeof(UINT_t));
+  memcpy(graph2->colInd, graph->colInd, graph->numEdges * sizeof(VERTEX_t));
+  readonly_graph(graph2);
+  return graph2;
+}
 
+void free_protected_graph(GRAPH_TYPE* graph) {
+  size_t rowPtrOffset, colIndOffset;
+  const size_t len = mapped_graph_layout(graph->numVertices, graph->numEdges, &rowPtrOffset, &colIndOffset);
+  munmap(graph, len);
 }
 
-void create_graph_RMAT(GRAPH_TYPE* graph, const UINT_t scale) {
+/* Rows up to this length are insertion sorted, longer ones radix sorted */
+#define ROW_INSERTION_SORT_MAX  64
 
-    register int good;
-    register UINT_t src, dst;
+static void insertion_sort(VERTEX_t *a, const UINT_t n) {
+  for (UINT_t i = 1 ; i < n ; i++) {
+    const VERTEX_t x = a[i];
+    UINT_t j = i;
+    while ((j > 0) && (a[j-1] > x)) {
+      a[j] = a[j-1];
+      j--;
+    }
+    a[j] = x;
+  }
+}
 
-    edge_t* edges = (edge_t*)calloc(graph->numEdges, sizeof(edge_t));
-    assert_malloc(edges);
+/* Sort the column indices within each row. Rows are handed out dynamically
+   since their lengths vary widely; each thread owns a scratch buffer big
+   enough for the longest row. */
+static void sort_rows(GRAPH_TYPE* graph) {
+  const UINT_t n = graph->numVertices;
+  const UINT_t* Ap = graph->rowPtr;
+  VERTEX_t* Ai = graph->colInd;
+  const int keyBits = edge_key_shift(n);
 
-    UINT_t e_start = 0;
+  UINT_t maxDegree = 0;
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static) reduction(max:maxDegree)
+#endif
+  for (UINT_t v = 0 ; v < n ; v++)
+    maxDegree = max(maxDegree, Ap[v+1] - Ap[v]);
 
-    for (UINT_t e = e_start ; e < graph->numEdges ; e+=2) {
+#ifdef PARALLEL
+#pragma omp parallel
+#endif
+  {
+    VERTEX_t *tmp = NULL;
+    if (maxDegree > ROW_INSERTION_SORT_MAX) {
+      tmp = (VERTEX_t *)malloc(maxDegree * sizeof(VERTEX_t));
+      assert_malloc(tmp);
+    }
 
-      good = 0;
+#ifdef PARALLEL
+#pragma omp for schedule(dynamic,256)
+#endif
+    for (UINT_t v = 0 ; v < n ; v++) {
+      const UINT_t d = Ap[v+1] - Ap[v];
+      if (d <= ROW_INSERTION_SORT_MAX)
+	insertion_sort(Ai + Ap[v], d);
+      else
+	radix_sort_uint(Ai + Ap[v], tmp, d, keyBits);
+    }
 
-      while (!good) {
-	src = 0;
-	dst = 0;
+    free(tmp);
+  }
+}
 
-	for (UINT_t level = 0; level < scale; level++) {
-	  double randNum = (double)rand() / RAND_MAX;
+/* Build the CSR arrays from graph->numEdges packed edge keys (see sort.h):
+   1. each thread counts the sources of its own block of keys,
+   2. a prefix sum over (vertex, thread) turns the per-thread degree
+      histograms into rowPtr and into per-thread write offsets,
+   3. each thread scatters its block to its own offsets, without atomics,
+   4. the rows are sorted, unless the keys came in sorted order (the scatter
+      is stable, so the rows are then already sorted).
+   The histograms take numThreads * n words, so the thread count is capped
+   by the average degree to keep them within the size of the edge list. */
+void convert_edges_to_graph(const uint64_t* keys, const int shift, const bool sorted, GRAPH_TYPE* graph) {
+  const UINT_t n = graph->numVertices;
+  const UINT_t m = graph->numEdges;
+  UINT_t* Ap = graph->rowPtr;
+  VERTEX_t* Ai = graph->colInd;
 
-	  double a = 0.57, b = 0.19, c = 0.19; /* d = 1 - a - b - c */
+  if (n == 0) return;
 
-	  if (randNum < a)
-	    continue;
-	  else if (randNum < a + b)
-	    dst |= 1 << level;
-	  else if (randNum < a + b + c)
-	    src |= 1 << level;
-	  else {
-	    src |= 1 << level;
-	    dst |= 1 << level;
-	  }
-	}
+  int numThreads = 1;
+#ifdef PARALLEL
+  if (m >= 65536)
+    numThreads = (int)min((UINT_t)omp_get_max_threads(), 1 + m / n);
+#endif
+  const UINT_t blockSize = (m + numThreads - 1) / numThreads;
 
-	good = 1;
+  UINT_t *offset = (UINT_t *)malloc((size_t)numThreads * n * sizeof(UINT_t));
+  assert_malloc(offset);
 
-	/* Only keep unique edges */
-	for (UINT_t i = 0; i<e ; i++)
-	  if ((edges[i].src == src) && (edges[i].dst == dst)) good = 0;
-	/* Do not keep self-loops */
-	if (src == dst) good = 0;
-      }
+  /* Per-thread degree histograms */
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static,1) num_threads(numThreads)
+#endif
+  for (int t = 0 ; t < numThreads ; t++) {
+    UINT_t *h = offset + (size_t)t * n;
+    const UINT_t lo = min(m, t * blockSize);
+    const UINT_t hi = min(m, lo + blockSize);
+    memset(h, 0, n * sizeof(UINT_t));
+    for (UINT_t i = lo ; i < hi ; i++)
+      h[EDGE_KEY_SRC(keys[i], shift)]++;
+  }
 
-      edges[e  ].src = src;
-      edges[e  ].dst = dst;
-      edges[e+1].src = dst;
-      edges[e+1].dst = src;
-#if DEBUG
-      fprintf(stdout,"Edge[%5d]: (%5d, %5d)\n",e, edges[e].src, edges[e].dst);
+  /* Degrees, and each thread's offset within each row */
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static) num_threads(numThreads)
 #endif
+  for (UINT_t v = 0 ; v < n ; v++) {
+    UINT_t sum = 0;
+    for (int t = 0 ; t < numThreads ; t++) {
+      const UINT_t c = offset[(size_t)t * n + v];
+      offset[(size_t)t * n + v] = sum;
+      sum += c;
     }
+    Ap[v] = sum;
+  }
+  Ap[n] = 0;
+  prefix_sum(Ap, n + 1);
 
-    convert_edges_to_graph(edges,graph);
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static) num_threads(numThreads)
+#endif
+  for (UINT_t v = 0 ; v < n ; v++)
+    for (int t = 0 ; t < numThreads ; t++)
+      offset[(size_t)t * n + v] += Ap[v];
 
-    free(edges);
-}
+  /* Scatter */
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static,1) num_threads(numThreads)
+#endif
+  for (int t = 0 ; t < numThreads ; t++) {
+    UINT_t *h = offset + (size_t)t * n;
+    const UINT_t lo = min(m, t * blockSize);
+    const UINT_t hi = min(m, lo + blockSize);
+    for (UINT_t i = lo ; i < hi ; i++)
+      Ai[h[EDGE_KEY_SRC(keys[i], shift)]++] = EDGE_KEY_DST(keys[i], shift);
+  }
 
+  free(offset);
 
+  if (!sorted)
+    sort_rows(graph);
+}
 
 void print_graph(const GRAPH_TYPE* graph, FILE *outfile) {
   const UINT_t* Ap = graph->rowPtr;
-  const UINT_t* Ai = graph->colInd;
+  const VERTEX_t* Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
   
-  fprintf(outfile,"Number of Vertices: %u\n", n);
-  fprintf(outfile,"Number of Edges: %u\n", m);
+  fprintf(outfile,"Number of Vertices: %" PRIUINT "\n", n);
+  fprintf(outfile,"Number of Edges: %" PRIUINT "\n", m);
   fprintf(outfile,"RowPtr: ");
   for (UINT_t i = 0; i <= n; i++)
-    fprintf(outfile,"%u ", Ap[i]);
+    fprintf(outfile,"%" PRIUINT " ", Ap[i]);
   fprintf(outfile,"\n");
   fprintf(outfile,"ColInd: ");
   for (UINT_t i = 0; i < m; i++)
-    fprintf(outfile,"%u ", Ai[i]);
+    fprintf(outfile,"%" PRIVERTEX " ", Ai[i]);
   fprintf(outfile,"\n");
 }
 
+/* Hash of the graph structure. Each row is hashed on its own, as 64-bit
+   values, and the rows are combined with their index, so the result is the
+   same for every build width and number of threads. */
+uint64_t graph_fingerprint(const GRAPH_TYPE* graph) {
+  const UINT_t* restrict Ap = graph->rowPtr;
+  const VERTEX_t* restrict Ai = graph->colInd;
+  const UINT_t n = graph->numVertices;
+  uint64_t sum = random_mix64((uint64_t)n) ^ random_mix64((uint64_t)graph->numEdges + 1);
+
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static) reduction(+:sum)
+#endif
+  for (UINT_t v = 0 ; v < n ; v++) {
+    uint64_t h = (uint64_t)(Ap[v+1] - Ap[v]);
+    for (UINT_t i = Ap[v] ; i < Ap[v+1] ; i++)
+      h = (h ^ (uint64_t)Ai[i]) * 0x9E3779B97F4A7C15ULL;
+    sum += random_mix64(h + (uint64_t)v);
+  }
+  return sum;
+}
+
 bool check_edge(const GRAPH_TYPE *graph, const UINT_t v, const UINT_t w) {
 
   const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
+  const VERTEX_t* restrict Ai = graph->colInd;
 
   UINT_t s = Ap[v];
   UINT_t e = Ap[v+1];
@@ -210,7 +312,7 @@ GRAPH_TYPE *reorder_graph_by_degree(const GRAPH_TYPE *graph, enum reorderDegree_
   register UINT_t b, e;
 
   const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
+  const VERTEX_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
 
@@ -241,7 +343,7 @@ GRAPH_TYPE *reorder_graph_by_degree(const GRAPH_TYPE *graph, enum reorderDegree_
   graph2->numEdges = m;
   allocate_graph(graph2);
   UINT_t* restrict Ap2 = graph2->rowPtr;
-  UINT_t* restrict Ai2 = graph2->colInd;
+  VERTEX_t* restrict Ai2 = graph2->colInd;
 
   Ap2[0] = 0;
   for (UINT_t i=1 ; i<=n ; i++)
@@ -273,38 +375,23 @@ GRAPH_TYPE *reorder_graph_by_degree(const GRAPH_TYPE *graph, enum reorderDegree_
   return graph2;
 }
 
+/* The merge itself is intersect_count (intersect.c) */
 UINT_t intersectSizeMergePath(const GRAPH_TYPE* graph, const UINT_t v, const UINT_t w) {
   register UINT_t vb, ve, wb, we;
-  register UINT_t ptr_v, ptr_w;
-  UINT_t count = 0;
 
   const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
+  const VERTEX_t* restrict Ai = graph->colInd;
   
   vb = Ap[v ];
   ve = Ap[v+1];
   wb = Ap[w  ];
   we = Ap[w+1];
 
-  ptr_v = vb;
-  ptr_w = wb;
-  while ((ptr_v < ve) && (ptr_w < we)) {
-    if (Ai[ptr_v] == Ai[ptr_w]) {
-      count++;
-      ptr_v++;
-      ptr_w++;
-    }
-    else
-      if (Ai[ptr_v] < Ai[ptr_w])
-	ptr_v++;
-      else
-	ptr_w++;
-  }
-  return count;
+  return intersect_count(Ai + vb, ve - vb, Ai + wb, we - wb);
 }
 
 
-static INT_t binarySearch(const UINT_t* list, const UINT_t start, const UINT_t end, const UINT_t target) {
+static INT_t binarySearch(const VERTEX_t* list, const UINT_t start, const UINT_t end, const UINT_t target) {
   register INT_t s=start, e=end, mid;
   while (s < e) {
     mid = s + (e - s) / 2;
@@ -324,7 +411,7 @@ UINT_t intersectSizeBinarySearch(const GRAPH_TYPE* graph, const UINT_t v, const
   UINT_t count=0;
 
   const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
+  const VERTEX_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   if ((v<0) || (v >= n) || (w<0) || (w >= n)) {
@@ -341,16 +428,16 @@ UINT_t intersectSizeBinarySearch(const GRAPH_TYPE* graph, const UINT_t v, const
 
   if (size_v <= size_w) {
     for (UINT_t i=vb ; i<ve ; i++)
-      if (binarySearch((UINT_t *)Ai, wb, we, Ai[i])>=0) count++;
+      if (binarySearch(Ai, wb, we, Ai[i])>=0) count++;
   } else {
     for (UINT_t i=wb ; i<we ; i++)
-      if (binarySearch((UINT_t *)Ai, vb, ve, Ai[i])>=0) count++;
+      if (binarySearch(Ai, vb, ve, Ai[i])>=0) count++;
   }
 
   return count;
 }
 
-static UINT_t binarySearch_partition(const UINT_t* list, const UINT_t start, const UINT_t end, const UINT_t target) {
+static UINT_t binarySearch_partition(const VERTEX_t* list, const UINT_t start, const UINT_t end, const UINT_t target) {
   register INT_t s=start, e=end, mid;
   while (s < e) {
     mid = s + (e - s) / 2;
@@ -373,7 +460,7 @@ static UINT_t binarySearch_partition(const UINT_t* list, const UINT_t start, con
 
 
 
-UINT_t searchLists_with_partitioning(const UINT_t* list1, const INT_t s1, const INT_t e1, const UINT_t* list2, const INT_t s2, const INT_t e2) {
+UINT_t searchLists_with_partitioning(const VERTEX_t* list1, const INT_t s1, const INT_t e1, const VERTEX_t* list2, const INT_t s2, const INT_t e2) {
   INT_t mid1, loc2;
   UINT_t count = 0;
 
@@ -420,20 +507,25 @@ UINT_t searchLists_with_partitioning(const UINT_t* list1, const INT_t s1, const
 }
 
 
-UINT_t intersectSizeHash(const GRAPH_TYPE *graph, bool *Hash, const UINT_t v, const UINT_t w) {
+UINT_t intersectSizeHash(const GRAPH_TYPE *graph, MARK_T(MARK_INTERSECT) *Hash, const UINT_t v, const UINT_t w) {
 
   register UINT_t vb, ve, wb, we;
   register UINT_t s1, e1, s2, e2;
   UINT_t count = 0;
   
   const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
+  const VERTEX_t* restrict Ai = graph->colInd;
 
   vb = Ap[v  ];
   ve = Ap[v+1];
   wb = Ap[w  ];
   we = Ap[w+1];
 
+  /* A hub's bitmap replaces marking its list in Hash */
+  const INT_t hv = hub_of(graph, v), hw = hub_of(graph, w);
+  if ((hv >= 0) || (hw >= 0))
+    return hub_intersect(hv, hw, Ai + vb, ve - vb, Ai + wb, we - wb, graph->numVertices);
+
   if ((ve-vb) < (we-wb)) {
     s1 = vb;
     e1 = ve;
@@ -446,49 +538,57 @@ UINT_t intersectSizeHash(const GRAPH_TYPE *graph, bool *Hash, const UINT_t v, co
     e2 = ve;
   }
   
+  MARK(MARK_INTERSECT, next)(Hash);
   for (UINT_t i=s1 ; i<e1 ; i++)
-    Hash[Ai[i]] = true;
+    MARK(MARK_INTERSECT, set)(Hash, Ai[i]);
 
   for (UINT_t i= s2; i<e2 ; i++)
-    if (Hash[Ai[i]]) count++;
+    count += MARK(MARK_INTERSECT, test)(Hash, Ai[i]);
 
   for (UINT_t i=s1 ; i<e1 ; i++)
-    Hash[Ai[i]] = false;
+    MARK(MARK_INTERSECT, unset)(Hash, Ai[i]);
 
   return count;
 }
 
 
-UINT_t intersectSizeMergePath_forward(const GRAPH_TYPE* graph, const UINT_t v, const UINT_t w, const UINT_t* A, const UINT_t* Size) {
-  register UINT_t vb, ve, wb, we;
-  register UINT_t ptr_v, ptr_w;
-  UINT_t count = 0;
-
+/* Galloping search of the shorter list in the longer one (intersect.c) */
+UINT_t intersectSizeGallop(const GRAPH_TYPE* graph, const UINT_t v, const UINT_t w) {
   const UINT_t* restrict Ap = graph->rowPtr;
-  
-  vb = Ap[v  ];
-  ve = vb + Size[v];
-  wb = Ap[w  ];
-  we = wb + Size[w];
+  const VERTEX_t* restrict Ai = graph->colInd;
+  const UINT_t dv = Ap[v+1] - Ap[v];
+  const UINT_t dw = Ap[w+1] - Ap[w];
 
-  ptr_v = vb;
-  ptr_w = wb;
-  while ((ptr_v < ve) && (ptr_w < we)) {
-    if (A[ptr_v] == A[ptr_w]) {
-      count++;
-      ptr_v++;
-      ptr_w++;
-    }
-    else
-      if (A[ptr_v] < A[ptr_w])
-	ptr_v++;
-      else
-	ptr_w++;
+  if (dv <= dw)
+    return intersect_gallop(Ai + Ap[v], dv, Ai + Ap[w], dw);
+  return intersect_gallop(Ai + Ap[w], dw, Ai + Ap[v], dv);
+}
+
+/* Merge, hash or galloping, by the ratio of the degrees (intersect_method) */
+UINT_t intersectSizeAdaptive(const GRAPH_TYPE* graph, MARK_T(MARK_INTERSECT) *Hash, const UINT_t v, const UINT_t w) {
+  const UINT_t* restrict Ap = graph->rowPtr;
+  const VERTEX_t* restrict Ai = graph->colInd;
+  const UINT_t dv = Ap[v+1] - Ap[v];
+  const UINT_t dw = Ap[w+1] - Ap[w];
+
+  switch (intersect_method(min(dv, dw), max(dv, dw))) {
+  case INTERSECT_GALLOP:
+    return intersectSizeGallop(graph, v, w);
+  case INTERSECT_HASH:
+    return intersectSizeHash(graph, Hash, v, w);
+  default:
+    return intersect_count(Ai + Ap[v], dv, Ai + Ap[w], dw);
   }
-  return count;
 }
 
-UINT_t intersectSizeHash_forward(const GRAPH_TYPE *graph, bool *Hash, const UINT_t v, const UINT_t w, const UINT_t* A, const UINT_t* Size) {
+
+UINT_t intersectSizeMergePath_forward(const GRAPH_TYPE* graph, const UINT_t v, const UINT_t w, const UINT_t* A, const UINT_t* Size) {
+  const UINT_t* restrict Ap = graph->rowPtr;
+
+  return intersect_count_uint(A + Ap[v], Size[v], A + Ap[w], Size[w]);
+}
+
+UINT_t intersectSizeHash_forward(const GRAPH_TYPE *graph, MARK_T(MARK_INTERSECT) *Hash, const UINT_t v, const UINT_t w, const UINT_t* A, const UINT_t* Size) {
 
   register UINT_t vb, ve, wb, we;
   register UINT_t s1, e1, s2, e2;
@@ -501,6 +601,12 @@ UINT_t intersectSizeHash_forward(const GRAPH_TYPE *graph, bool *Hash, const UINT
   wb = Ap[w  ];
   we = wb + Size[w];
 
+  /* The forward lists of v < w hold the neighbors below v, and a hub's
+     bitmap all of them */
+  const INT_t hv = hub_of(graph, v), hw = hub_of(graph, w);
+  if ((hv >= 0) || (hw >= 0))
+    return hub_intersect_uint(hv, hw, A + vb, Size[v], A + wb, Size[w], min(v, w));
+
   if (Size[v] < Size[w]) {
     s1 = vb;
     e1 = ve;
@@ -513,83 +619,38 @@ UINT_t intersectSizeHash_forward(const GRAPH_TYPE *graph, bool *Hash, const UINT
     e2 = ve;
   }
 
+  MARK(MARK_INTERSECT, next)(Hash);
   for (UINT_t i=s1 ; i<e1 ; i++)
-    Hash[A[i]] = true;
+    MARK(MARK_INTERSECT, set)(Hash, A[i]);
 
   for (UINT_t i= s2; i<e2 ; i++)
-    if (Hash[A[i]]) count++;
+    count += MARK(MARK_INTERSECT, test)(Hash, A[i]);
   
   for (UINT_t i=s1 ; i<e1 ; i++)
-    Hash[A[i]] = false;
+    MARK(MARK_INTERSECT, unset)(Hash, A[i]);
     
   return count;
 }
 
-#ifdef PARALLEL
-UINT_t intersectSizeHash_forward_P(const GRAPH_TYPE *graph, bool *Hash, const UINT_t v, const UINT_t w, const UINT_t* A, const UINT_t* Size) {
-
-  register UINT_t vb, ve, wb, we;
-  register UINT_t s1, e1, s2, e2;
-  UINT_t count = 0;
-  int numThreads;
-  UINT_t *mycount;
-
+/* The same on the oriented lists of the forward kernels */
+UINT_t intersectSizeAdaptive_forward(const GRAPH_TYPE *graph, MARK_T(MARK_INTERSECT) *Hash, const UINT_t v, const UINT_t w, const UINT_t* A, const UINT_t* Size) {
   const UINT_t* restrict Ap = graph->rowPtr;
-
-  vb = Ap[v  ];
-  ve = vb + Size[v];
-  wb = Ap[w  ];
-  we = wb + Size[w];
-
-  if (Size[v] < Size[w]) {
-    s1 = vb;
-    e1 = ve;
-    s2 = wb;
-    e2 = we;
-  } else {
-    s1 = wb;
-    e1 = we;
-    s2 = vb;
-    e2 = ve;
+  const UINT_t dv = Size[v];
+  const UINT_t dw = Size[w];
+
+  switch (intersect_method(min(dv, dw), max(dv, dw))) {
+  case INTERSECT_GALLOP:
+    if (dv <= dw)
+      return intersect_gallop_uint(A + Ap[v], dv, A + Ap[w], dw);
+    return intersect_gallop_uint(A + Ap[w], dw, A + Ap[v], dv);
+  case INTERSECT_HASH:
+    return intersectSizeHash_forward(graph, Hash, v, w, A, Size);
+  default:
+    return intersect_count_uint(A + Ap[v], dv, A + Ap[w], dw);
   }
-
-#pragma omp parallel
-  {
-
-    int myID = omp_get_thread_num();
-    if (myID==0) {
-      numThreads = omp_get_num_threads();
-      
-      mycount = (UINT_t *)calloc(numThreads, sizeof(UINT_t));
-      assert_malloc(mycount);
-    }
-#pragma omp barrier
-#pragma omp for
-    for (UINT_t i=s1 ; i<e1 ; i++)
-      Hash[A[i]] = true;
-
-#pragma omp for
-    for (UINT_t i= s2; i<e2 ; i++)
-      if (Hash[A[i]]) mycount[myID]++;
-  
-#pragma omp for
-    for (UINT_t i=s1 ; i<e1 ; i++) 
-      Hash[A[i]] = false;
-
-#pragma omp for reduction(+:count)
-    for (int i = 0; i < numThreads ; i++)
-      count += mycount[i];
-
-  }
-
-  free(mycount);
-    
-  return count;
 }
-#endif
-
 
-UINT_t intersectSizeHashSkip_forward(const GRAPH_TYPE *graph, bool *Hash, const UINT_t v, const UINT_t w, const UINT_t* A, const UINT_t* Size) {
+UINT_t intersectSizeHashSkip_forward(const GRAPH_TYPE *graph, MARK_T(MARK_INTERSECT) *Hash, const UINT_t v, const UINT_t w, const UINT_t* A, const UINT_t* Size) {
 
   register UINT_t s1, e1, s2, e2;
   UINT_t count = 0;
@@ -610,14 +671,15 @@ UINT_t intersectSizeHashSkip_forward(const GRAPH_TYPE *graph, bool *Hash, const
     e2 = s2 + Size[v];
   }
 
+  MARK(MARK_INTERSECT, next)(Hash);
   for (UINT_t i=s1 ; i<e1 ; i++)
-    Hash[A[i]] = true;
+    MARK(MARK_INTERSECT, set)(Hash, A[i]);
 
   for (UINT_t i=s2 ; i<e2 ; i++)
-    if (Hash[A[i]]) count++;
+    count += MARK(MARK_INTERSECT, test)(Hash, A[i]);
 
   for (UINT_t i=s1 ; i<e1 ; i++)
-    Hash[A[i]] = false;
+    MARK(MARK_INTERSECT, unset)(Hash, A[i]);
 
   return count;
 }
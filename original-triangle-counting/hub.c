@@ -0,0 +1,192 @@
+#include "types.h"
+#include "graph.h"
+#include "hub.h"
+
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(__clang__)
+#define HUB_POPCNT_CLONES  __attribute__((target_clones("popcnt", "default")))
+#else
+#define HUB_POPCNT_CLONES
+#endif
+
+hubBitmaps_t hubBitmaps = { NULL, 0, 0, 0, NULL, NULL, NULL, 0 };
+
+typedef struct {
+  UINT_t degree;
+  UINT_t index;
+} hubCandidate_t;
+
+/* Decreasing degree, then increasing id */
+static int compareCandidate(const void *a, const void *b) {
+  const hubCandidate_t *c1 = (const hubCandidate_t *)a;
+  const hubCandidate_t *c2 = (const hubCandidate_t *)b;
+  if (c1->degree != c2->degree) return (c1->degree > c2->degree) ? -1 : 1;
+  return (c1->index < c2->index) ? -1 : (c1->index > c2->index);
+}
+
+static int compareId(const void *a, const void *b) {
+  const UINT_t x = *(const UINT_t *)a, y = *(const UINT_t *)b;
+  return (x < y) ? -1 : (x > y);
+}
+
+/* Non-empty blocks of the sorted list of v */
+static UINT_t count_blocks(const GRAPH_TYPE *graph, const UINT_t v) {
+  UINT_t blocks = 0, last = 0;
+  for (UINT_t i = graph->rowPtr[v] ; i < graph->rowPtr[v+1] ; i++) {
+    const UINT_t b = graph->colInd[i] / HUB_BLOCK_BITS;
+    if ((blocks == 0) || (b != last)) blocks++;
+    last = b;
+  }
+  return blocks;
+}
+
+/* Bitmaps of up to k hubs of degree at least HUB_MIN_DEGREE, the highest
+   degrees first, as long as they fit in budget bytes */
+void hub_build(const GRAPH_TYPE *graph, const UINT_t k, const size_t budget) {
+  const UINT_t* restrict Ap = graph->rowPtr;
+  const VERTEX_t* restrict Ai = graph->colInd;
+  const UINT_t n = graph->numVertices;
+  const UINT_t numBlocks = (n + HUB_BLOCK_BITS - 1) / HUB_BLOCK_BITS;
+  UINT_t numCandidates = 0, numHubs = 0;
+  size_t bytes = 0, numWords = 0;
+
+  hub_free();
+
+  for (UINT_t v = 0 ; v < n ; v++)
+    if (Ap[v+1] - Ap[v] >= HUB_MIN_DEGREE) numCandidates++;
+  if ((numCandidates == 0) || (k == 0)) return;
+
+  hubCandidate_t *candidates = (hubCandidate_t *)malloc(numCandidates * sizeof(hubCandidate_t));
+  assert_malloc(candidates);
+  numCandidates = 0;
+  for (UINT_t v = 0 ; v < n ; v++)
+    if (Ap[v+1] - Ap[v] >= HUB_MIN_DEGREE) {
+      candidates[numCandidates].degree = Ap[v+1] - Ap[v];
+      candidates[numCandidates].index = v;
+      numCandidates++;
+    }
+  qsort(candidates, numCandidates, sizeof(hubCandidate_t), compareCandidate);
+
+  /* Stop at the first hub that does not fit, so that the hubs are
+     always the highest degrees */
+  while (numHubs < min(k, numCandidates)) {
+    const size_t words = (size_t)count_blocks(graph, candidates[numHubs].index) * HUB_BLOCK_WORDS;
+    const size_t hubBytes = sizeof(UINT_t) + numBlocks * sizeof(uint32_t) + words * sizeof(uint64_t);
+    if ((bytes + hubBytes > budget) || (numWords + words >= HUB_EMPTY)) break;
+    bytes += hubBytes;
+    numWords += words;
+    numHubs++;
+  }
+  if (numHubs == 0) {
+    free(candidates);
+    return;
+  }
+
+  hubBitmaps.id = (UINT_t *)malloc(numHubs * sizeof(UINT_t));
+  assert_malloc(hubBitmaps.id);
+  for (UINT_t h = 0 ; h < numHubs ; h++)
+    hubBitmaps.id[h] = candidates[h].index;
+  hubBitmaps.minDegree = candidates[numHubs - 1].degree;
+  free(candidates);
+  qsort(hubBitmaps.id, numHubs, sizeof(UINT_t), compareId);
+
+  hubBitmaps.block = (uint32_t *)malloc((size_t)numHubs * numBlocks * sizeof(uint32_t));
+  assert_malloc(hubBitmaps.block);
+  memset(hubBitmaps.block, 0xff, (size_t)numHubs * numBlocks * sizeof(uint32_t));
+  hubBitmaps.words = (uint64_t *)calloc(max(numWords, 1), sizeof(uint64_t));
+  assert_malloc(hubBitmaps.words);
+
+  uint32_t next = 0;
+  for (UINT_t h = 0 ; h < numHubs ; h++) {
+    const UINT_t v = hubBitmaps.id[h];
+    uint32_t *block = hubBitmaps.block + (size_t)h * numBlocks;
+    for (UINT_t i = Ap[v] ; i < Ap[v+1] ; i++) {
+      const UINT_t x = Ai[i];
+      const UINT_t b = x / HUB_BLOCK_BITS;
+      if (block[b] == HUB_EMPTY) {
+	block[b] = next;
+	next += HUB_BLOCK_WORDS;
+      }
+      hubBitmaps.words[block[b] + (x % HUB_BLOCK_BITS) / 64] |= (uint64_t)1 << (x % 64);
+    }
+  }
+
+  hubBitmaps.numHubs = numHubs;
+  hubBitmaps.numBlocks = numBlocks;
+  hubBitmaps.bytes = bytes;
+  hubBitmaps.graph = graph;
+}
+
+void hub_free(void) {
+  free(hubBitmaps.id);
+  free(hubBitmaps.block);
+  free(hubBitmaps.words);
+  hubBitmaps = (hubBitmaps_t) { NULL, 0, 0, 0, NULL, NULL, NULL, 0 };
+}
+
+/* Elements of the list adjacent to hub h */
+UINT_t hub_count(const INT_t h, const VERTEX_t *list, const UINT_t len) {
+  UINT_t count = 0;
+  for (UINT_t i = 0 ; i < len ; i++)
+    count += hub_test(h, list[i]);
+  return count;
+}
+
+static UINT_t hub_count_uint(const INT_t h, const UINT_t *list, const UINT_t len) {
+  UINT_t count = 0;
+  for (UINT_t i = 0 ; i < len ; i++)
+    count += hub_test(h, list[i]);
+  return count;
+}
+
+/* Common neighbors of hubs h and g below limit */
+HUB_POPCNT_CLONES
+UINT_t hub_and_count(const INT_t h, const INT_t g, const UINT_t limit) {
+  const uint32_t *bh = hubBitmaps.block + (size_t)h * hubBitmaps.numBlocks;
+  const uint32_t *bg = hubBitmaps.block + (size_t)g * hubBitmaps.numBlocks;
+  const uint64_t *words = hubBitmaps.words;
+  const UINT_t fullBlocks = limit / HUB_BLOCK_BITS;
+  UINT_t count = 0;
+
+  for (UINT_t b = 0 ; b < fullBlocks ; b++)
+    if ((bh[b] != HUB_EMPTY) && (bg[b] != HUB_EMPTY))
+      for (int i = 0 ; i < HUB_BLOCK_WORDS ; i++)
+	count += __builtin_popcountll(words[bh[b] + i] & words[bg[b] + i]);
+
+  /* The block of limit, up to its bit */
+  const UINT_t rest = limit % HUB_BLOCK_BITS;
+  if ((rest > 0) && (bh[fullBlocks] != HUB_EMPTY) && (bg[fullBlocks] != HUB_EMPTY)) {
+    const uint64_t *wh = words + bh[fullBlocks], *wg = words + bg[fullBlocks];
+    UINT_t i;
+    for (i = 0 ; i < rest / 64 ; i++)
+      count += __builtin_popcountll(wh[i] & wg[i]);
+    if (rest % 64)
+      count += __builtin_popcountll(wh[i] & wg[i] & (((uint64_t)1 << (rest % 64)) - 1));
+  }
+  return count;
+}
+
+/* Size of the intersection of list a of vertex v and list b of vertex
+   w, where h and g are the hub numbers of v and w (-1 if not a hub) and
+   at least one is a hub. The lists need not be the whole adjacency
+   lists, but must hold every neighbor of their vertex below limit and
+   nothing else: each hub bitmap is only tested with elements of the
+   other list, or ANDed with the other bitmap below limit when both are
+   hubs and the shorter list is dense enough in the blocks. */
+#define HUB_INTERSECT(h, g, a, na, b, nb, limit, count_list)		\
+  if ((h >= 0) && (g >= 0)) {						\
+    const UINT_t shorter = min(na, nb);					\
+    if (shorter >= ((limit + HUB_BLOCK_BITS - 1) / HUB_BLOCK_BITS) * HUB_BLOCK_WORDS) \
+      return hub_and_count(h, g, limit);				\
+    return (na <= nb) ? count_list(g, a, na) : count_list(h, b, nb);	\
+  }									\
+  return (h >= 0) ? count_list(h, b, nb) : count_list(g, a, na);
+
+UINT_t hub_intersect(const INT_t h, const INT_t g, const VERTEX_t *a, const UINT_t na,
+		     const VERTEX_t *b, const UINT_t nb, const UINT_t limit) {
+  HUB_INTERSECT(h, g, a, na, b, nb, limit, hub_count);
+}
+
+UINT_t hub_intersect_uint(const INT_t h, const INT_t g, const UINT_t *a, const UINT_t na,
+			  const UINT_t *b, const UINT_t nb, const UINT_t limit) {
+  HUB_INTERSECT(h, g, a, na, b, nb, limit, hub_count_uint);
+}
@@ -0,0 +1,69 @@
+#ifndef _HUB_H
+#define _HUB_H
+
+#include "placement.h"
+
+/* Persistent bitmaps of the adjacency lists of the highest degree
+   vertices (hubs), built once per graph with --hubs. Where a hash kernel
+   would mark a hub's list in its Hash array and clear it again, it tests
+   the hub's bits instead, and two dense hubs intersect by a word-wise AND
+   and popcount. The vertex ids are split into blocks of HUB_BLOCK_BITS
+   and only the non-empty blocks of a bitmap are stored. Hubs are taken in
+   decreasing order of degree while they fit in the memory budget.
+
+   With -N replicate the bitmaps are built once, from the first replica,
+   and serve the threads of every node, whose kernels read their own
+   replica (local_graph); they are not replicated themselves. */
+
+#define HUB_BLOCK_BITS      1024
+#define HUB_BLOCK_WORDS     (HUB_BLOCK_BITS / 64)
+#define HUB_EMPTY           UINT32_MAX
+#define HUB_MIN_DEGREE      64                      /* smaller vertices are never hubs */
+#define HUB_DEFAULT_BUDGET  ((size_t)256 << 20)     /* bytes */
+#define HUB_SHORTER         16                      /* a list tested against a hub, where the marks
+							       of its vertex are set anyway, is this many
+							       times shorter than the hub's */
+
+typedef struct {
+  const GRAPH_TYPE *graph;   /* the graph of the bitmaps, NULL if none */
+  UINT_t numHubs;
+  UINT_t minDegree;          /* smallest degree of a hub */
+  UINT_t numBlocks;          /* blocks of a bitmap */
+  UINT_t *id;                /* the hubs, in increasing order */
+  uint32_t *block;           /* numHubs x numBlocks: offset of the block in words, or HUB_EMPTY */
+  uint64_t *words;           /* the non-empty blocks */
+  size_t bytes;
+} hubBitmaps_t;
+
+extern hubBitmaps_t hubBitmaps;
+
+void hub_build(const GRAPH_TYPE *, const UINT_t, const size_t);
+void hub_free(void);
+UINT_t hub_count(const INT_t, const VERTEX_t *, const UINT_t);
+UINT_t hub_and_count(const INT_t, const INT_t, const UINT_t);
+UINT_t hub_intersect(const INT_t, const INT_t, const VERTEX_t *, const UINT_t, const VERTEX_t *, const UINT_t, const UINT_t);
+UINT_t hub_intersect_uint(const INT_t, const INT_t, const UINT_t *, const UINT_t, const UINT_t *, const UINT_t, const UINT_t);
+
+/* The hub number of v, or -1 if v is not a hub of graph, which may be
+   any replica of the graph of the bitmaps */
+static INLINE INT_t hub_of(const GRAPH_TYPE *graph, const UINT_t v) {
+  if ((hubBitmaps.graph == NULL) || (graph->rowPtr[v+1] - graph->rowPtr[v] < hubBitmaps.minDegree))
+    return -1;
+  if ((graph != hubBitmaps.graph) && !is_replica_of(graph, hubBitmaps.graph))
+    return -1;
+
+  UINT_t lo = 0, hi = hubBitmaps.numHubs;
+  while (lo < hi) {
+    const UINT_t mid = lo + (hi - lo) / 2;
+    if (hubBitmaps.id[mid] < v) lo = mid + 1; else hi = mid;
+  }
+  return ((lo < hubBitmaps.numHubs) && (hubBitmaps.id[lo] == v)) ? (INT_t)lo : -1;
+}
+
+/* Is x adjacent to hub h */
+static INLINE bool hub_test(const INT_t h, const UINT_t x) {
+  const uint32_t offset = hubBitmaps.block[(size_t)h * hubBitmaps.numBlocks + x / HUB_BLOCK_BITS];
+  return (offset != HUB_EMPTY) && ((hubBitmaps.words[offset + (x % HUB_BLOCK_BITS) / 64] >> (x % 64)) & 1);
+}
+
+#endif
@@ -0,0 +1,552 @@
+#include "types.h"
+#include "graph.h"
+#include "intersect.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define INTERSECT_X86
+#include <immintrin.h>
+#endif
+
+/* Sorted list intersection. The SIMD versions compare a block of each
+   list all-against-all (a block against every rotation of the other),
+   add the matches of the block of a, and advance the block with the
+   smaller last element, or both if equal. Since the lists have no
+   duplicates, every common element is found exactly once. What is left
+   after the last whole block is merged by the scalar code. Each version
+   is compiled for its instruction set with a target attribute, so the
+   binary runs anywhere and intersect_init picks the first supported one
+   of isaPreference. */
+
+static enum intersectIsa_t intersectIsa = INTERSECT_SCALAR;
+static const char *isaName[INTERSECT_NUM_ISA] = INTERSECT_ISA_NAMES;
+
+/* Wider is not faster: the 16 x 16 AVX-512 block needs 15 rotations and
+   compares, and ran the merge at 0.7-0.9 ns per element against 0.4-0.5
+   for AVX2 (intersect_bench -n 128,1024 -r 1,3 -v 0,0.5). Only
+   VP2INTERSECT, one instruction per block, goes before AVX2. */
+static const enum intersectIsa_t isaPreference[] = {
+  INTERSECT_VP2INTERSECT, INTERSECT_AVX2, INTERSECT_AVX512, INTERSECT_SSE42, INTERSECT_SCALAR
+};
+
+/* Branchless merge: both indices advance on equal elements */
+#define SCALAR_COUNT(a, na, b, nb, i, j, count)		\
+  while ((i < na) && (j < nb)) {			\
+    const uint64_t x = a[i], y = b[j];			\
+    count += (x == y);					\
+    i += (x <= y);					\
+    j += (y <= x);					\
+  }
+
+#define SCALAR_LIST(a, na, b, nb, i, j, count, out)	\
+  while ((i < na) && (j < nb)) {			\
+    const uint64_t x = a[i], y = b[j];			\
+    out[count] = a[i];					\
+    count += (x == y);					\
+    i += (x <= y);					\
+    j += (y <= x);					\
+  }
+
+static UINT_t count_u32_scalar(const uint32_t *a, const UINT_t na, const uint32_t *b, const UINT_t nb) {
+  UINT_t i = 0, j = 0, count = 0;
+  SCALAR_COUNT(a, na, b, nb, i, j, count);
+  return count;
+}
+
+static UINT_t list_u32_scalar(const uint32_t *a, const UINT_t na, const uint32_t *b, const UINT_t nb, uint32_t *out) {
+  UINT_t i = 0, j = 0, count = 0;
+  SCALAR_LIST(a, na, b, nb, i, j, count, out);
+  return count;
+}
+
+UINT_t intersect_count_u64(const uint64_t *a, const UINT_t na, const uint64_t *b, const UINT_t nb) {
+  UINT_t i = 0, j = 0, count = 0;
+  SCALAR_COUNT(a, na, b, nb, i, j, count);
+  return count;
+}
+
+UINT_t intersect_list_u64(const uint64_t *a, const UINT_t na, const uint64_t *b, const UINT_t nb, uint64_t *out) {
+  UINT_t i = 0, j = 0, count = 0;
+  SCALAR_LIST(a, na, b, nb, i, j, count, out);
+  return count;
+}
+
+UINT_t (*intersect_count_u32)(const uint32_t *, const UINT_t, const uint32_t *, const UINT_t) = count_u32_scalar;
+UINT_t (*intersect_list_u32)(const uint32_t *, const UINT_t, const uint32_t *, const UINT_t, uint32_t *) = list_u32_scalar;
+
+/* Advance past the block with the smaller last element */
+#define NEXT_BLOCKS(a, b, i, j, W) {			\
+    const uint32_t lastA = a[i + W - 1];		\
+    const uint32_t lastB = b[j + W - 1];		\
+    i += (lastA <= lastB) ? W : 0;			\
+    j += (lastB <= lastA) ? W : 0;			\
+  }
+
+#ifdef INTERSECT_X86
+
+/* Shuffle controls that move the lanes of a match mask to the front, for
+   intersect_list: 4 x 32-bit lanes (pshufb bytes) and 8 x 32-bit lanes
+   (vpermd indices) */
+static uint8_t compress4[16][16];
+static uint32_t compress8[256][8];
+
+static void init_compress_tables(void) {
+  for (int mask = 0 ; mask < 16 ; mask++) {
+    int k = 0;
+    memset(compress4[mask], 0x80, 16);
+    for (int lane = 0 ; lane < 4 ; lane++)
+      if (mask & (1 << lane)) {
+	for (int byte = 0 ; byte < 4 ; byte++)
+	  compress4[mask][4*k + byte] = 4*lane + byte;
+	k++;
+      }
+  }
+  for (int mask = 0 ; mask < 256 ; mask++) {
+    int k = 0;
+    for (int lane = 0 ; lane < 8 ; lane++)
+      if (mask & (1 << lane))
+	compress8[mask][k++] = lane;
+    while (k < 8)
+      compress8[mask][k++] = 0;
+  }
+}
+
+/* SSE4.2: 4 x 4 blocks */
+__attribute__((target("sse4.2,popcnt")))
+static INLINE int match4(const uint32_t *a, const uint32_t *b) {
+  const __m128i va = _mm_loadu_si128((const __m128i *)a);
+  const __m128i vb = _mm_loadu_si128((const __m128i *)b);
+  __m128i m = _mm_cmpeq_epi32(va, vb);
+  m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0,3,2,1))));
+  m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1,0,3,2))));
+  m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2,1,0,3))));
+  return _mm_movemask_ps(_mm_castsi128_ps(m));
+}
+
+__attribute__((target("sse4.2,popcnt")))
+static UINT_t count_u32_sse42(const uint32_t *a, const UINT_t na, const uint32_t *b, const UINT_t nb) {
+  UINT_t i = 0, j = 0, count = 0;
+  const UINT_t na4 = na & ~(UINT_t)3, nb4 = nb & ~(UINT_t)3;
+  while ((i < na4) && (j < nb4)) {
+    count += _mm_popcnt_u32(match4(a + i, b + j));
+    NEXT_BLOCKS(a, b, i, j, 4);
+  }
+  SCALAR_COUNT(a, na, b, nb, i, j, count);
+  return count;
+}
+
+__attribute__((target("sse4.2,popcnt")))
+static UINT_t list_u32_sse42(const uint32_t *a, const UINT_t na, const uint32_t *b, const UINT_t nb, uint32_t *out) {
+  UINT_t i = 0, j = 0, count = 0;
+  const UINT_t na4 = na & ~(UINT_t)3, nb4 = nb & ~(UINT_t)3;
+  while ((i < na4) && (j < nb4)) {
+    const int mask = match4(a + i, b + j);
+    const __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+    _mm_storeu_si128((__m128i *)(out + count), _mm_shuffle_epi8(va, _mm_loadu_si128((const __m128i *)compress4[mask])));
+    count += _mm_popcnt_u32(mask);
+    NEXT_BLOCKS(a, b, i, j, 4);
+  }
+  SCALAR_LIST(a, na, b, nb, i, j, count, out);
+  return count;
+}
+
+/* AVX2: 8 x 8 blocks, the rotations within each 128-bit half of b and of
+   b with its halves swapped */
+__attribute__((target("avx2,popcnt")))
+static INLINE int match8(const uint32_t *a, const uint32_t *b) {
+  const __m256i va = _mm256_loadu_si256((const __m256i *)a);
+  const __m256i vb = _mm256_loadu_si256((const __m256i *)b);
+  const __m256i vs = _mm256_permute2x128_si256(vb, vb, 1);
+  __m256i m = _mm256_cmpeq_epi32(va, vb);
+  m = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vb, _MM_SHUFFLE(0,3,2,1))));
+  m = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vb, _MM_SHUFFLE(1,0,3,2))));
+  m = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vb, _MM_SHUFFLE(2,1,0,3))));
+  m = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, vs));
+  m = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vs, _MM_SHUFFLE(0,3,2,1))));
+  m = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vs, _MM_SHUFFLE(1,0,3,2))));
+  m = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vs, _MM_SHUFFLE(2,1,0,3))));
+  return _mm256_movemask_ps(_mm256_castsi256_ps(m));
+}
+
+__attribute__((target("avx2,popcnt")))
+static UINT_t count_u32_avx2(const uint32_t *a, const UINT_t na, const uint32_t *b, const UINT_t nb) {
+  UINT_t i = 0, j = 0, count = 0;
+  const UINT_t na8 = na & ~(UINT_t)7, nb8 = nb & ~(UINT_t)7;
+  while ((i < na8) && (j < nb8)) {
+    count += _mm_popcnt_u32(match8(a + i, b + j));
+    NEXT_BLOCKS(a, b, i, j, 8);
+  }
+  SCALAR_COUNT(a, na, b, nb, i, j, count);
+  return count;
+}
+
+__attribute__((target("avx2,popcnt")))
+static UINT_t list_u32_avx2(const uint32_t *a, const UINT_t na, const uint32_t *b, const UINT_t nb, uint32_t *out) {
+  UINT_t i = 0, j = 0, count = 0;
+  const UINT_t na8 = na & ~(UINT_t)7, nb8 = nb & ~(UINT_t)7;
+  while ((i < na8) && (j < nb8)) {
+    const int mask = match8(a + i, b + j);
+    const __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+    const __m256i perm = _mm256_loadu_si256((const __m256i *)compress8[mask]);
+    _mm256_storeu_si256((__m256i *)(out + count), _mm256_permutevar8x32_epi32(va, perm));
+    count += _mm_popcnt_u32(mask);
+    NEXT_BLOCKS(a, b, i, j, 8);
+  }
+  SCALAR_LIST(a, na, b, nb, i, j, count, out);
+  return count;
+}
+
+/* AVX-512: 16 x 16 blocks against the 16 rotations of b */
+#define ROTATE_MATCH(k)  m |= _mm512_cmpeq_epi32_mask(va, _mm512_alignr_epi32(vb, vb, k))
+
+__attribute__((target("avx512f,popcnt")))
+static INLINE __mmask16 match16(const __m512i va, const __m512i vb) {
+  __mmask16 m = _mm512_cmpeq_epi32_mask(va, vb);
+  ROTATE_MATCH(1);  ROTATE_MATCH(2);  ROTATE_MATCH(3);  ROTATE_MATCH(4);
+  ROTATE_MATCH(5);  ROTATE_MATCH(6);  ROTATE_MATCH(7);  ROTATE_MATCH(8);
+  ROTATE_MATCH(9);  ROTATE_MATCH(10); ROTATE_MATCH(11); ROTATE_MATCH(12);
+  ROTATE_MATCH(13); ROTATE_MATCH(14); ROTATE_MATCH(15);
+  return m;
+}
+
+__attribute__((target("avx512f,popcnt")))
+static UINT_t count_u32_avx512(const uint32_t *a, const UINT_t na, const uint32_t *b, const UINT_t nb) {
+  UINT_t i = 0, j = 0, count = 0;
+  const UINT_t na16 = na & ~(UINT_t)15, nb16 = nb & ~(UINT_t)15;
+  while ((i < na16) && (j < nb16)) {
+    const __m512i va = _mm512_loadu_si512((const void *)(a + i));
+    const __m512i vb = _mm512_loadu_si512((const void *)(b + j));
+    count += _mm_popcnt_u32(match16(va, vb));
+    NEXT_BLOCKS(a, b, i, j, 16);
+  }
+  SCALAR_COUNT(a, na, b, nb, i, j, count);
+  return count;
+}
+
+__attribute__((target("avx512f,popcnt")))
+static UINT_t list_u32_avx512(const uint32_t *a, const UINT_t na, const uint32_t *b, const UINT_t nb, uint32_t *out) {
+  UINT_t i = 0, j = 0, count = 0;
+  const UINT_t na16 = na & ~(UINT_t)15, nb16 = nb & ~(UINT_t)15;
+  while ((i < na16) && (j < nb16)) {
+    const __m512i va = _mm512_loadu_si512((const void *)(a + i));
+    const __m512i vb = _mm512_loadu_si512((const void *)(b + j));
+    const __mmask16 mask = match16(va, vb);
+    _mm512_mask_compressstoreu_epi32((void *)(out + count), mask, va);
+    count += _mm_popcnt_u32(mask);
+    NEXT_BLOCKS(a, b, i, j, 16);
+  }
+  SCALAR_LIST(a, na, b, nb, i, j, count, out);
+  return count;
+}
+
+/* VP2INTERSECT compares the 16 x 16 block in one instruction */
+#if (__GNUC__ >= 10) || defined(__clang__)
+#define HAVE_VP2INTERSECT
+
+__attribute__((target("avx512f,avx512vp2intersect,popcnt")))
+static UINT_t count_u32_vp2intersect(const uint32_t *a, const UINT_t na, const uint32_t *b, const UINT_t nb) {
+  UINT_t i = 0, j = 0, count = 0;
+  const UINT_t na16 = na & ~(UINT_t)15, nb16 = nb & ~(UINT_t)15;
+  while ((i < na16) && (j < nb16)) {
+    __mmask16 ma, mb;
+    const __m512i va = _mm512_loadu_si512((const void *)(a + i));
+    const __m512i vb = _mm512_loadu_si512((const void *)(b + j));
+    _mm512_2intersect_epi32(va, vb, &ma, &mb);
+    count += _mm_popcnt_u32(ma);
+    NEXT_BLOCKS(a, b, i, j, 16);
+  }
+  SCALAR_COUNT(a, na, b, nb, i, j, count);
+  return count;
+}
+
+__attribute__((target("avx512f,avx512vp2intersect,popcnt")))
+static UINT_t list_u32_vp2intersect(const uint32_t *a, const UINT_t na, const uint32_t *b, const UINT_t nb, uint32_t *out) {
+  UINT_t i = 0, j = 0, count = 0;
+  const UINT_t na16 = na & ~(UINT_t)15, nb16 = nb & ~(UINT_t)15;
+  while ((i < na16) && (j < nb16)) {
+    __mmask16 ma, mb;
+    const __m512i va = _mm512_loadu_si512((const void *)(a + i));
+    const __m512i vb = _mm512_loadu_si512((const void *)(b + j));
+    _mm512_2intersect_epi32(va, vb, &ma, &mb);
+    _mm512_mask_compressstoreu_epi32((void *)(out + count), ma, va);
+    count += _mm_popcnt_u32(ma);
+    NEXT_BLOCKS(a, b, i, j, 16);
+  }
+  SCALAR_LIST(a, na, b, nb, i, j, count, out);
+  return count;
+}
+#endif
+
+static bool isa_supported(const enum intersectIsa_t isa) {
+  __builtin_cpu_init();
+  switch (isa) {
+  case INTERSECT_SCALAR:       return true;
+  case INTERSECT_SSE42:        return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+  case INTERSECT_AVX2:         return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+  case INTERSECT_AVX512:       return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("popcnt");
+#ifdef HAVE_VP2INTERSECT
+  case INTERSECT_VP2INTERSECT: return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vp2intersect");
+#endif
+  default:                     return false;
+  }
+}
+
+#else
+
+static bool isa_supported(const enum intersectIsa_t isa) {
+  return isa == INTERSECT_SCALAR;
+}
+
+#endif
+
+/* The preferred instruction set of the CPU, or the named one */
+void intersect_init(const char *name) {
+  enum intersectIsa_t isa = INTERSECT_SCALAR;
+
+  if (name != NULL) {
+    while ((isa < INTERSECT_NUM_ISA) && (strcmp(name, isaName[isa]) != 0))
+      isa++;
+    if ((isa == INTERSECT_NUM_ISA) || !isa_supported(isa)) {
+      fprintf(stderr,"ERROR: Intersection instruction set %s is unknown or not supported by this CPU\n", name);
+      exit(8);
+    }
+  }
+  else
+    for (size_t i = 0 ; i < sizeof(isaPreference) / sizeof(isaPreference[0]) ; i++)
+      if (isa_supported(isaPreference[i])) {
+	isa = isaPreference[i];
+	break;
+      }
+
+  intersectIsa = isa;
+  intersect_count_u32 = count_u32_scalar;
+  intersect_list_u32 = list_u32_scalar;
+#ifdef INTERSECT_X86
+  init_compress_tables();
+  switch (isa) {
+  case INTERSECT_SSE42:
+    intersect_count_u32 = count_u32_sse42;
+    intersect_list_u32 = list_u32_sse42;
+    break;
+  case INTERSECT_AVX2:
+    intersect_count_u32 = count_u32_avx2;
+    intersect_list_u32 = list_u32_avx2;
+    break;
+  case INTERSECT_AVX512:
+    intersect_count_u32 = count_u32_avx512;
+    intersect_list_u32 = list_u32_avx512;
+    break;
+#ifdef HAVE_VP2INTERSECT
+  case INTERSECT_VP2INTERSECT:
+    intersect_count_u32 = count_u32_vp2intersect;
+    intersect_list_u32 = list_u32_vp2intersect;
+    break;
+#endif
+  default:
+    break;
+  }
+#endif
+}
+
+const char *intersect_isa_name(void) {
+  return isaName[intersectIsa];
+}
+
+/* Output list for intersect_list, long enough for any row of graph */
+VERTEX_t *intersect_alloc(const GRAPH_TYPE *graph) {
+  UINT_t maxDegree = 0;
+  for (UINT_t v = 0 ; v < graph->numVertices ; v++)
+    maxDegree = max(maxDegree, graph->rowPtr[v+1] - graph->rowPtr[v]);
+
+  VERTEX_t *out = (VERTEX_t *)malloc((maxDegree + INTERSECT_PAD) * sizeof(VERTEX_t));
+  assert_malloc(out);
+  return out;
+}
+
+/* Galloping: each element of the shorter list a is looked up in b by an
+   exponential search from where the previous one stopped, then a binary
+   search within the last step, so a pair costs O(na log(nb / na))
+   instead of O(na + nb). */
+#define GALLOP_COUNT(a, na, b, nb, count) {				\
+    UINT_t j = 0;							\
+    for (UINT_t i = 0 ; (i < na) && (j < nb) ; i++) {			\
+      const uint64_t x = a[i];						\
+      if (b[j] < x) {							\
+	UINT_t lo = j, hi = j + 1, step = 1;				\
+	while ((hi < nb) && (b[hi] < x)) {				\
+	  lo = hi;							\
+	  step <<= 1;							\
+	  hi = lo + step;						\
+	}								\
+	if (hi > nb) hi = nb;						\
+	/* b[lo] < x and (hi == nb or b[hi] >= x) */			\
+	while (hi - lo > 1) {						\
+	  const UINT_t mid = lo + (hi - lo) / 2;			\
+	  if (b[mid] < x) lo = mid; else hi = mid;			\
+	}								\
+	j = hi;								\
+	if (j == nb) break;						\
+      }									\
+      if (b[j] == x) {							\
+	count++;							\
+	j++;								\
+      }									\
+    }									\
+  }
+
+UINT_t intersect_gallop_u32(const uint32_t *a, const UINT_t na, const uint32_t *b, const UINT_t nb) {
+  UINT_t count = 0;
+  GALLOP_COUNT(a, na, b, nb, count);
+  return count;
+}
+
+UINT_t intersect_gallop_u64(const uint64_t *a, const UINT_t na, const uint64_t *b, const UINT_t nb) {
+  UINT_t count = 0;
+  GALLOP_COUNT(a, na, b, nb, count);
+  return count;
+}
+
+/* Crossovers of intersect_method, as ratios of the longer to the shorter
+   length. The defaults are --crossovers calibrate of RMAT scale 18 on one
+   core of an AVX-512 x86-64 machine (gcc -O2, avx512 merge). */
+double intersectHashRatio = 4.0;
+double intersectGallopRatio = 128.0;
+
+#define CALIBRATE_BUCKETS   24          /* ratio buckets 1, 2, 4, ... */
+#define CALIBRATE_PAIRS     4096        /* edges sampled per bucket */
+#define CALIBRATE_MIN_PAIRS 16          /* fewer and the bucket is skipped */
+#define CALIBRATE_ELEMENTS  (1 << 21)   /* list elements per timed batch */
+#define CALIBRATE_BATCHES   3           /* best of */
+
+/* Seconds per pass over the sampled pairs (v[k], w[k]) of a bucket */
+static double time_method(const enum intersectMethod_t method, const GRAPH_TYPE *graph,
+			  const UINT_t *v, const UINT_t *w, const UINT_t pairs, bool *mark, UINT_t *expected) {
+  const UINT_t* restrict Ap = graph->rowPtr;
+  const VERTEX_t* restrict Ai = graph->colInd;
+  UINT_t elements = 0;
+  double best = 0.0;
+
+  for (UINT_t k = 0 ; k < pairs ; k++)
+    elements += (Ap[v[k]+1] - Ap[v[k]]) + (Ap[w[k]+1] - Ap[w[k]]);
+  const UINT_t reps = max(1, CALIBRATE_ELEMENTS / max(1, elements));
+
+  for (int batch = 0 ; batch < CALIBRATE_BATCHES ; batch++) {
+    UINT_t count = 0;
+    const double t = get_seconds();
+    for (UINT_t r = 0 ; r < reps ; r++) {
+      count = 0;
+      for (UINT_t k = 0 ; k < pairs ; k++) {
+	/* a is the shorter list */
+	const VERTEX_t *a = Ai + Ap[v[k]], *b = Ai + Ap[w[k]];
+	const UINT_t na = Ap[v[k]+1] - Ap[v[k]], nb = Ap[w[k]+1] - Ap[w[k]];
+	switch (method) {
+	case INTERSECT_MERGE:
+	  count += intersect_count(a, na, b, nb);
+	  break;
+	case INTERSECT_GALLOP:
+	  count += intersect_gallop(a, na, b, nb);
+	  break;
+	case INTERSECT_HASH:
+	  for (UINT_t i = 0 ; i < na ; i++) mark[a[i]] = true;
+	  for (UINT_t i = 0 ; i < nb ; i++) count += mark[b[i]];
+	  for (UINT_t i = 0 ; i < na ; i++) mark[a[i]] = false;
+	  break;
+	}
+      }
+    }
+    const double elapsed = (get_seconds() - t) / reps;
+    if ((method != INTERSECT_MERGE) && (count != *expected)) {
+      fprintf(stderr,"ERROR: Intersection calibration counted %" PRIUINT " instead of %" PRIUINT "\n", count, *expected);
+      exit(8);
+    }
+    *expected = count;
+    if ((batch == 0) || (elapsed < best)) best = elapsed;
+  }
+  return best;
+}
+
+/* Sample up to CALIBRATE_PAIRS edges of the graph per bucket of the
+   ratio of the larger to the smaller degree (1, 2, 4, ...), time the
+   three methods on the lists of each bucket, and set each crossover to
+   the lowest ratio at which its method is the fastest. Real pairs keep
+   the locality of the graph, which decides between the merge and the
+   hash. A method that never wins gets an infinite ratio. */
+void intersect_calibrate(const GRAPH_TYPE *graph, FILE *outfile) {
+  const UINT_t* restrict Ap = graph->rowPtr;
+  const VERTEX_t* restrict Ai = graph->colInd;
+  const UINT_t n = graph->numVertices;
+  const UINT_t step = max(1, graph->numEdges / (CALIBRATE_BUCKETS * CALIBRATE_PAIRS));
+  UINT_t pairs[CALIBRATE_BUCKETS] = { 0 };
+  bool foundHash = false, foundGallop = false;
+
+  UINT_t *v = (UINT_t *)malloc(CALIBRATE_BUCKETS * CALIBRATE_PAIRS * sizeof(UINT_t));
+  assert_malloc(v);
+  UINT_t *w = (UINT_t *)malloc(CALIBRATE_BUCKETS * CALIBRATE_PAIRS * sizeof(UINT_t));
+  assert_malloc(w);
+  bool *mark = (bool *)calloc(n, sizeof(bool));
+  assert_malloc(mark);
+
+  /* Every step-th adjacency list entry, each edge once */
+  for (UINT_t x = 0, i = 0 ; x < n ; x++)
+    for ( ; i < Ap[x+1] ; i += step) {
+      const UINT_t y = Ai[i];
+      const UINT_t dx = Ap[x+1] - Ap[x], dy = Ap[y+1] - Ap[y];
+      if (x >= y) continue;
+      int bucket = 0;
+      while ((bucket < CALIBRATE_BUCKETS - 1) && ((min(dx, dy) << (bucket + 1)) <= max(dx, dy)))
+	bucket++;
+      if (pairs[bucket] == CALIBRATE_PAIRS) continue;
+      const UINT_t k = bucket * CALIBRATE_PAIRS + pairs[bucket]++;
+      v[k] = (dx <= dy) ? x : y;
+      w[k] = (dx <= dy) ? y : x;
+    }
+
+  intersectHashRatio = HUGE_VAL;
+  intersectGallopRatio = HUGE_VAL;
+
+  for (int bucket = 0 ; bucket < CALIBRATE_BUCKETS ; bucket++) {
+    const UINT_t *bv = v + bucket * CALIBRATE_PAIRS, *bw = w + bucket * CALIBRATE_PAIRS;
+    const double ratio = (double)((UINT_t)1 << bucket);
+    UINT_t expected = 0;
+    double t[3];
+
+    if (pairs[bucket] < CALIBRATE_MIN_PAIRS) continue;
+    t[INTERSECT_MERGE] = time_method(INTERSECT_MERGE, graph, bv, bw, pairs[bucket], mark, &expected);
+    t[INTERSECT_HASH] = time_method(INTERSECT_HASH, graph, bv, bw, pairs[bucket], mark, &expected);
+    t[INTERSECT_GALLOP] = time_method(INTERSECT_GALLOP, graph, bv, bw, pairs[bucket], mark, &expected);
+    if (outfile != NULL)
+      fprintf(outfile,"CROSSOVER\t%8.0f\t%6" PRIUINT " pairs\tmerge %10.1f\thash %10.1f\tgallop %10.1f\tns per pair\n",
+	      ratio, pairs[bucket], 1.0e9 * t[INTERSECT_MERGE] / pairs[bucket],
+	      1.0e9 * t[INTERSECT_HASH] / pairs[bucket], 1.0e9 * t[INTERSECT_GALLOP] / pairs[bucket]);
+
+    if (!foundHash && (t[INTERSECT_HASH] < t[INTERSECT_MERGE])) {
+      intersectHashRatio = ratio;
+      foundHash = true;
+    }
+    if (!foundGallop && (t[INTERSECT_GALLOP] < min(t[INTERSECT_MERGE], t[INTERSECT_HASH]))) {
+      intersectGallopRatio = ratio;
+      foundGallop = true;
+    }
+  }
+
+  free(mark);
+  free(w);
+  free(v);
+}
+
+/* --crossovers: "hash,gallop" ratios, or "calibrate" to measure them
+   on the graph */
+void intersect_crossovers(const char *spec, const GRAPH_TYPE *graph, FILE *outfile) {
+  double hash, gallop;
+  char extra;
+
+  if (strcmp(spec, "calibrate") == 0) {
+    intersect_calibrate(graph, outfile);
+    return;
+  }
+  if ((sscanf(spec, "%lf,%lf%c", &hash, &gallop, &extra) != 2) || (hash < 1.0) || (gallop < 1.0)) {
+    fprintf(stderr,"ERROR: Crossovers %s are not two ratios of at least 1 (hash,gallop) or calibrate\n", spec);
+    exit(8);
+  }
+  intersectHashRatio = hash;
+  intersectGallopRatio = gallop;
+}
@@ -0,0 +1,95 @@
+#ifndef _INTERSECT_H
+#define _INTERSECT_H
+
+/* Sizes of the intersections of sorted lists without duplicates, the
+   inner loop of the merge-based kernels. The 32-bit versions compare
+   blocks of both lists with SIMD instructions, chosen at startup by
+   intersect_init from the features of the CPU (or forced with
+   --intersect). 64-bit lists use the branchless scalar merge. */
+enum intersectIsa_t {
+  INTERSECT_SCALAR = 0,
+  INTERSECT_SSE42,
+  INTERSECT_AVX2,
+  INTERSECT_AVX512,
+  INTERSECT_VP2INTERSECT,
+  INTERSECT_NUM_ISA
+};
+
+#define INTERSECT_ISA_NAMES  { "scalar", "sse4.2", "avx2", "avx512", "vp2intersect" }
+
+/* Room after the last element written by intersect_list: the SIMD
+   versions store whole vectors */
+#define INTERSECT_PAD  16
+
+extern UINT_t (*intersect_count_u32)(const uint32_t *, const UINT_t, const uint32_t *, const UINT_t);
+extern UINT_t (*intersect_list_u32)(const uint32_t *, const UINT_t, const uint32_t *, const UINT_t, uint32_t *);
+UINT_t intersect_count_u64(const uint64_t *, const UINT_t, const uint64_t *, const UINT_t);
+UINT_t intersect_list_u64(const uint64_t *, const UINT_t, const uint64_t *, const UINT_t, uint64_t *);
+
+UINT_t intersect_gallop_u32(const uint32_t *, const UINT_t, const uint32_t *, const UINT_t);
+UINT_t intersect_gallop_u64(const uint64_t *, const UINT_t, const uint64_t *, const UINT_t);
+
+void intersect_init(const char *);
+const char *intersect_isa_name(void);
+VERTEX_t *intersect_alloc(const GRAPH_TYPE *);
+
+/* Per pair choice of the adaptive kernels by the ratio of the longer to
+   the shorter length: the merge below intersectHashRatio, a hash of the
+   shorter list up to intersectGallopRatio and galloping beyond. The
+   crossovers are set with --crossovers, measured on this machine by
+   intersect_calibrate or left at the built-in defaults. */
+enum intersectMethod_t { INTERSECT_MERGE = 0, INTERSECT_HASH, INTERSECT_GALLOP };
+
+extern double intersectHashRatio;
+extern double intersectGallopRatio;
+
+void intersect_calibrate(const GRAPH_TYPE *, FILE *);
+void intersect_crossovers(const char *, const GRAPH_TYPE *, FILE *);
+
+/* Method for lists of ns <= nl elements */
+static INLINE enum intersectMethod_t intersect_method(const UINT_t ns, const UINT_t nl) {
+  if ((double)nl >= intersectGallopRatio * (double)ns)
+    return INTERSECT_GALLOP;
+  if ((double)nl >= intersectHashRatio * (double)ns)
+    return INTERSECT_HASH;
+  return INTERSECT_MERGE;
+}
+
+/* Number of common elements of a[0..na) and b[0..nb) */
+static INLINE UINT_t intersect_count(const VERTEX_t *a, const UINT_t na, const VERTEX_t *b, const UINT_t nb) {
+  if (sizeof(VERTEX_t) == sizeof(uint32_t))
+    return intersect_count_u32((const uint32_t *)a, na, (const uint32_t *)b, nb);
+  return intersect_count_u64((const uint64_t *)a, na, (const uint64_t *)b, nb);
+}
+
+/* The same for lists of UINT_t, such as the oriented lists of the
+   forward kernels */
+static INLINE UINT_t intersect_count_uint(const UINT_t *a, const UINT_t na, const UINT_t *b, const UINT_t nb) {
+  if (sizeof(UINT_t) == sizeof(uint32_t))
+    return intersect_count_u32((const uint32_t *)a, na, (const uint32_t *)b, nb);
+  return intersect_count_u64((const uint64_t *)a, na, (const uint64_t *)b, nb);
+}
+
+/* Galloping intersection, for a much shorter than b */
+static INLINE UINT_t intersect_gallop(const VERTEX_t *a, const UINT_t na, const VERTEX_t *b, const UINT_t nb) {
+  if (sizeof(VERTEX_t) == sizeof(uint32_t))
+    return intersect_gallop_u32((const uint32_t *)a, na, (const uint32_t *)b, nb);
+  return intersect_gallop_u64((const uint64_t *)a, na, (const uint64_t *)b, nb);
+}
+
+static INLINE UINT_t intersect_gallop_uint(const UINT_t *a, const UINT_t na, const UINT_t *b, const UINT_t nb) {
+  if (sizeof(UINT_t) == sizeof(uint32_t))
+    return intersect_gallop_u32((const uint32_t *)a, na, (const uint32_t *)b, nb);
+  return intersect_gallop_u64((const uint64_t *)a, na, (const uint64_t *)b, nb);
+}
+
+/* The common elements, in order, written to out, which needs room for
+   min(na, nb) + INTERSECT_PAD elements (intersect_alloc); returns how
+   many */
+static INLINE UINT_t intersect_list(const VERTEX_t *a, const UINT_t na, const VERTEX_t *b, const UINT_t nb, VERTEX_t *out) {
+  if (sizeof(VERTEX_t) == sizeof(uint32_t))
+    return intersect_list_u32((const uint32_t *)a, na, (const uint32_t *)b, nb, (uint32_t *)out);
+  return intersect_list_u64((const uint64_t *)a, na, (const uint64_t *)b, nb, (uint64_t *)out);
+}
+
+#endif
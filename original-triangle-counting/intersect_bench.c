@@ -0,0 +1,354 @@
+/* Microbenchmark of the list intersection routines of graph.c, the inner
+   loop of the intersection, forward and BFS based kernels.
+
+   Each case is a pair of sorted lists: the shorter one of a given length,
+   the longer one ratio times as long, and a given fraction of the shorter
+   list also in the longer one. Every routine intersects the pair
+   repeatedly and is reported in ns per element of both lists, followed by
+   a crossover map of the fastest routine for every case.
+
+   Built separately from tc: make intersect_bench */
+
+#include "types.h"
+#include "graph.h"
+#include "gen.h"
+#include "intersect.h"
+
+#define DEFAULT_LENGTHS   "16,128,1024"
+#define DEFAULT_RATIOS    "1,3,10,30,100,300,1000,3000,10000"
+#define DEFAULT_OVERLAPS  "0,0.1,0.5,1"
+#define DEFAULT_MIN_TIME  0.01      /* seconds per timed batch */
+#define BATCHES           3         /* best of */
+#define MAX_LIST          (1 << 26) /* longest list */
+#define MAX_VALUES        32
+
+bool QUIET = true;          /* read by placement.c, linked for hub_of */
+
+typedef struct {
+  VERTEX_t *list;           /* shorter list, then the longer one */
+  UINT_t *forwardList;      /* the same as UINT_t, for the _forward routines */
+  UINT_t rowPtr[3];
+  UINT_t size[2];
+  UINT_t lenA, lenB;
+  UINT_t common;
+  UINT_t universe;
+  GRAPH_TYPE graph;         /* the pair as the adjacency lists of vertices 0 and 1 */
+  MARK_T(MARK_INTERSECT) hash;
+} listPair_t;
+
+typedef UINT_t (*intersect_t)(listPair_t *);
+
+static UINT_t run_MergePath(listPair_t *p) {
+  return intersectSizeMergePath(&p->graph, 0, 1);
+}
+
+static UINT_t run_BinarySearch(listPair_t *p) {
+  return intersectSizeBinarySearch(&p->graph, 0, 1);
+}
+
+static UINT_t run_Partition(listPair_t *p) {
+  return searchLists_with_partitioning(p->list, 0, (INT_t)p->lenA - 1, p->list, (INT_t)p->lenA, (INT_t)(p->lenA + p->lenB) - 1);
+}
+
+static UINT_t run_Hash(listPair_t *p) {
+  return intersectSizeHash(&p->graph, &p->hash, 0, 1);
+}
+
+static UINT_t run_Gallop(listPair_t *p) {
+  return intersectSizeGallop(&p->graph, 0, 1);
+}
+
+static UINT_t run_Adaptive(listPair_t *p) {
+  return intersectSizeAdaptive(&p->graph, &p->hash, 0, 1);
+}
+
+static UINT_t run_MergePath_forward(listPair_t *p) {
+  return intersectSizeMergePath_forward(&p->graph, 0, 1, p->forwardList, p->size);
+}
+
+static UINT_t run_Hash_forward(listPair_t *p) {
+  return intersectSizeHash_forward(&p->graph, &p->hash, 0, 1, p->forwardList, p->size);
+}
+
+static UINT_t run_HashSkip_forward(listPair_t *p) {
+  return intersectSizeHashSkip_forward(&p->graph, &p->hash, 0, 1, p->forwardList, p->size);
+}
+
+static UINT_t run_Adaptive_forward(listPair_t *p) {
+  return intersectSizeAdaptive_forward(&p->graph, &p->hash, 0, 1, p->forwardList, p->size);
+}
+
+static const struct {
+  const char *name;
+  intersect_t run;
+} methods[] = {
+  { "MergePath",          run_MergePath         },
+  { "BinarySearch",       run_BinarySearch      },
+  { "Partition",          run_Partition         },
+  { "Hash",               run_Hash              },
+  { "Gallop",             run_Gallop            },
+  { "Adaptive",           run_Adaptive          },
+  { "MergePath_forward",  run_MergePath_forward },
+  { "Hash_forward",       run_Hash_forward      },
+  { "HashSkip_forward",   run_HashSkip_forward  },
+  { "Adaptive_forward",   run_Adaptive_forward  },
+};
+#define NUM_METHODS  (int)(sizeof(methods) / sizeof(methods[0]))
+
+static uint64_t SEED = RMAT_DEFAULT_SEED;
+static double MIN_TIME = DEFAULT_MIN_TIME;
+static char *ISA = NULL;
+static volatile UINT_t sink;   /* keeps the results live */
+static double lengths[MAX_VALUES], ratios[MAX_VALUES], overlaps[MAX_VALUES];
+static int numLengths, numRatios, numOverlaps;
+
+/* count values spread over [0, range): one uniform value in each of
+   count equal strata, so the values are sorted and distinct */
+static void stratified(uint64_t *out, const uint64_t count, const uint64_t range, const uint64_t stream) {
+  for (uint64_t i = 0 ; i < count ; i++) {
+    const uint64_t lo = i * range / count;
+    const uint64_t hi = (i + 1) * range / count;
+    out[i] = lo + random_u64(SEED, stream, i) % (hi - lo);
+  }
+}
+
+/* The longer list holds even values, so the odd values of the shorter
+   list are not in it */
+static void make_pair(listPair_t *p, const UINT_t lenA, const UINT_t lenB, const double overlap, const uint64_t stream) {
+  const UINT_t common = (UINT_t)(overlap * lenA + 0.5);
+  const uint64_t range = 2 * (uint64_t)lenB;
+
+  p->lenA = lenA;
+  p->lenB = lenB;
+  p->common = common;
+  p->universe = 2 * range;
+
+  uint64_t *b = (uint64_t *)malloc(lenB * sizeof(uint64_t));
+  assert_malloc(b);
+  uint64_t *pick = (uint64_t *)malloc((lenA + 1) * sizeof(uint64_t));
+  assert_malloc(pick);
+  uint64_t *odd = (uint64_t *)malloc((lenA + 1) * sizeof(uint64_t));
+  assert_malloc(odd);
+
+  stratified(b, lenB, range, 3*stream);
+  for (UINT_t i = 0 ; i < lenB ; i++)
+    b[i] *= 2;
+  stratified(pick, common, lenB, 3*stream + 1);
+  stratified(odd, lenA - common, range, 3*stream + 2);
+
+  p->list = (VERTEX_t *)malloc((lenA + lenB) * sizeof(VERTEX_t));
+  assert_malloc(p->list);
+  p->forwardList = (UINT_t *)malloc((lenA + lenB) * sizeof(UINT_t));
+  assert_malloc(p->forwardList);
+
+  /* Merge the common and the odd values into the shorter list */
+  UINT_t i = 0, j = 0;
+  for (UINT_t k = 0 ; k < lenA ; k++) {
+    if ((j == lenA - common) || ((i < common) && (b[pick[i]] < 2 * odd[j] + 1)))
+      p->list[k] = (VERTEX_t)b[pick[i++]];
+    else
+      p->list[k] = (VERTEX_t)(2 * odd[j++] + 1);
+  }
+  for (UINT_t k = 0 ; k < lenB ; k++)
+    p->list[lenA + k] = (VERTEX_t)b[k];
+  for (UINT_t k = 0 ; k < lenA + lenB ; k++)
+    p->forwardList[k] = p->list[k];
+
+  p->rowPtr[0] = 0;
+  p->rowPtr[1] = lenA;
+  p->rowPtr[2] = lenA + lenB;
+  p->size[0] = lenA;
+  p->size[1] = lenB;
+  p->graph.numVertices = 2;
+  p->graph.numEdges = lenA + lenB;
+  p->graph.rowPtr = p->rowPtr;
+  p->graph.colInd = p->list;
+
+  MARK(MARK_INTERSECT, alloc)(&p->hash, p->universe);
+
+  free(odd);
+  free(pick);
+  free(b);
+}
+
+static void free_pair(listPair_t *p) {
+  MARK(MARK_INTERSECT, free)(&p->hash);
+  free(p->forwardList);
+  free(p->list);
+}
+
+/* Best of BATCHES batches, each repeating the intersection for at least
+   MIN_TIME seconds; ns per element of both lists */
+static double time_method(const int m, listPair_t *p) {
+  double best = 0.0;
+
+  for (int batch = 0 ; batch < BATCHES ; batch++) {
+    uint64_t reps = 1;
+    double t;
+    while (1) {
+      t = get_seconds();
+      for (uint64_t r = 0 ; r < reps ; r++)
+	sink += methods[m].run(p);
+      t = get_seconds() - t;
+      if (t >= MIN_TIME) break;
+      reps *= 2;
+    }
+    const double ns = 1.0e9 * t / ((double)reps * (double)(p->lenA + p->lenB));
+    if ((batch == 0) || (ns < best)) best = ns;
+  }
+
+  return best;
+}
+
+static int parse_list(const char *s, double *values) {
+  int n = 0;
+  while (*s) {
+    char *end;
+    if (n == MAX_VALUES) break;
+    values[n++] = strtod(s, &end);
+    if ((end == s) || ((*end != ',') && (*end != '\0'))) {
+      fprintf(stderr,"ERROR: Cannot parse the list %s\n", s);
+      exit(8);
+    }
+    s = (*end == ',') ? end + 1 : end;
+  }
+  return n;
+}
+
+static void usage(void) {
+  printf("Intersection microbenchmark\n\n");
+  printf("Usage:\n\n");
+  printf(" -n #,#,...      [Lengths of the shorter list] (default %s)\n", DEFAULT_LENGTHS);
+  printf(" -r #,#,...      [Length ratios, longer / shorter] (default %s)\n", DEFAULT_RATIOS);
+  printf(" -v #,#,...      [Overlaps, fraction of the shorter list in the longer] (default %s)\n", DEFAULT_OVERLAPS);
+  printf(" -t seconds      [Minimum time of a timed batch] (default %.2f)\n", DEFAULT_MIN_TIME);
+  printf(" -s seed         [Random seed] (default %d)\n", RMAT_DEFAULT_SEED);
+  printf(" -i isa          [SIMD of MergePath: scalar, sse4.2, avx2, avx512, vp2intersect] (default the first supported of vp2intersect, avx2, avx512, sse4.2)\n");
+  exit (8);
+}
+
+static void parseFlags(int argc, char **argv) {
+  numLengths = parse_list(DEFAULT_LENGTHS, lengths);
+  numRatios = parse_list(DEFAULT_RATIOS, ratios);
+  numOverlaps = parse_list(DEFAULT_OVERLAPS, overlaps);
+
+  while ((argc > 1) && (argv[1][0] == '-')) {
+    if (argc < 3) usage();
+
+    switch (argv[1][1]) {
+
+    case 'n':
+      numLengths = parse_list(argv[2], lengths);
+      break;
+
+    case 'r':
+      numRatios = parse_list(argv[2], ratios);
+      break;
+
+    case 'v':
+      numOverlaps = parse_list(argv[2], overlaps);
+      break;
+
+    case 't':
+      MIN_TIME = atof(argv[2]);
+      break;
+
+    case 's':
+      SEED = strtoull(argv[2], NULL, 10);
+      break;
+
+    case 'i':
+      ISA = argv[2];
+      break;
+
+    default:
+      usage();
+    }
+    argv+=2;
+    argc-=2;
+  }
+
+  for (int i = 0 ; i < numOverlaps ; i++)
+    if ((overlaps[i] < 0.0) || (overlaps[i] > 1.0)) {
+      fprintf(stderr,"ERROR: Overlaps must be in [0,1]\n");
+      exit(8);
+    }
+  for (int i = 0 ; i < numLengths ; i++)
+    for (int j = 0 ; j < numRatios ; j++)
+      if ((lengths[i] < 1.0) || (ratios[j] < 1.0) || (lengths[i] * ratios[j] > MAX_LIST)) {
+	fprintf(stderr,"ERROR: Lengths and ratios must be >= 1, and the longer list at most %d\n", MAX_LIST);
+	exit(8);
+      }
+}
+
+int main(int argc, char **argv) {
+
+  parseFlags(argc, argv);
+  intersect_init(ISA);
+  printf("Merge intersections: %s\n", intersect_isa_name());
+
+  const int numCases = numLengths * numRatios * numOverlaps;
+  int *winner = (int *)malloc(numCases * sizeof(int));
+  assert_malloc(winner);
+  double *nsPerElement = (double *)malloc(NUM_METHODS * sizeof(double));
+  assert_malloc(nsPerElement);
+
+  printf("INTERSECT\tshorter\tlonger\tratio\toverlap");
+  for (int m = 0 ; m < NUM_METHODS ; m++)
+    printf("\t%s", methods[m].name);
+  printf("\t(ns per element)\n");
+
+  int c = 0;
+  for (int l = 0 ; l < numLengths ; l++)
+    for (int r = 0 ; r < numRatios ; r++)
+      for (int o = 0 ; o < numOverlaps ; o++, c++) {
+	listPair_t pair;
+	const UINT_t lenA = (UINT_t)lengths[l];
+	make_pair(&pair, lenA, (UINT_t)(lengths[l] * ratios[r]), overlaps[o], c);
+
+	for (int m = 0 ; m < NUM_METHODS ; m++) {
+	  const UINT_t count = methods[m].run(&pair);
+	  if (count != pair.common) {
+	    fprintf(stderr,"ERROR: %s found %" PRIUINT " common elements, expected %" PRIUINT "\n",
+		    methods[m].name, count, pair.common);
+	    exit(8);
+	  }
+	}
+
+	winner[c] = 0;
+	for (int m = 0 ; m < NUM_METHODS ; m++) {
+	  nsPerElement[m] = time_method(m, &pair);
+	  if (nsPerElement[m] < nsPerElement[winner[c]]) winner[c] = m;
+	}
+
+	printf("INTERSECT\t%" PRIUINT "\t%" PRIUINT "\t%g\t%g", pair.lenA, pair.lenB, ratios[r], overlaps[o]);
+	for (int m = 0 ; m < NUM_METHODS ; m++)
+	  printf("\t%.3f", nsPerElement[m]);
+	printf("\n");
+	fflush(stdout);
+
+	free_pair(&pair);
+      }
+
+  /* Crossover map: the fastest routine by ratio (rows) and overlap
+     (columns), one map per length of the shorter list */
+  c = 0;
+  for (int l = 0 ; l < numLengths ; l++) {
+    printf("\nCrossover map, shorter list %g elements (fastest routine)\n", lengths[l]);
+    printf("%10s", "ratio");
+    for (int o = 0 ; o < numOverlaps ; o++)
+      printf("  %-18g", overlaps[o]);
+    printf("\n");
+    for (int r = 0 ; r < numRatios ; r++) {
+      printf("%10g", ratios[r]);
+      for (int o = 0 ; o < numOverlaps ; o++, c++)
+	printf("  %-18s", methods[winner[c]].name);
+      printf("\n");
+    }
+  }
+
+  free(nsPerElement);
+  free(winner);
+
+  return(0);
+}
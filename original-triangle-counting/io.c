@@ -0,0 +1,512 @@
+#include "types.h"
+#include "graph.h"
+#include "io.h"
+#include "sort.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stddef.h>
+#ifdef PARALLEL
+#include <omp.h>
+#endif
+
+/* Matrix Market symmetry qualifiers. Only the sparsity pattern is used,
+   so the value columns of real, integer and complex files are skipped. */
+enum mmSymmetry_t { MM_GENERAL = 0, MM_SYMMETRIC, MM_SKEW_SYMMETRIC, MM_HERMITIAN };
+
+static const char *mmSymmetryName[] = { "general", "symmetric", "skew-symmetric", "hermitian" };
+
+enum mmError_t { MM_OK = 0, MM_BAD_ENTRY, MM_OUT_OF_RANGE };
+
+#define IS_DIGIT(c) ((unsigned)((c) - '0') < 10)
+
+static INLINE const char *skip_blanks(const char *p, const char *end) {
+  while ((p < end) && ((*p == ' ') || (*p == '\t') || (*p == '\r')))
+    p++;
+  return p;
+}
+
+static INLINE const char *next_line(const char *p, const char *end) {
+  const char *nl = (const char *)memchr(p, '\n', end - p);
+  return (nl == NULL) ? end : nl + 1;
+}
+
+/* Hand-rolled replacement for strtoul on a buffer that is not NUL terminated.
+   Returns NULL if there are no digits at p. */
+static INLINE const char *parse_uint(const char *p, const char *end, uint64_t *val) {
+  const char *s = p;
+  uint64_t v = 0;
+  while ((p < end) && IS_DIGIT(*p)) {
+    v = 10*v + (uint64_t)(*p - '0');
+    p++;
+  }
+  *val = v;
+  return (p == s) ? NULL : p;
+}
+
+static void mm_error(const char *filename, const char *msg) {
+  fprintf(stderr,"ERROR: Matrix Market file %s: %s\n", filename, msg);
+  exit(8);
+}
+
+static enum mmSymmetry_t mm_read_banner(const char *filename, const char *p, const char *end) {
+  char line[256], object[64], format[64], field[64], symmetry[64];
+  size_t len;
+
+  len = next_line(p, end) - p;
+  if (len > sizeof(line) - 1) len = sizeof(line) - 1;
+  memcpy(line, p, len);
+  line[len] = '\0';
+
+  if (sscanf(line, "%%%%MatrixMarket %63s %63s %63s %63s", object, format, field, symmetry) != 4)
+    mm_error(filename, "malformed banner");
+  if (strcasecmp(object, "matrix") != 0)
+    mm_error(filename, "only matrix objects are supported");
+  if (strcasecmp(format, "coordinate") != 0)
+    mm_error(filename, "only coordinate (sparse) matrices are supported");
+  if ((strcasecmp(field, "pattern") != 0) && (strcasecmp(field, "real") != 0) &&
+      (strcasecmp(field, "integer") != 0) && (strcasecmp(field, "complex") != 0) &&
+      (strcasecmp(field, "double") != 0))
+    mm_error(filename, "unknown field qualifier");
+
+  for (int i = 0 ; i < (int)(sizeof(mmSymmetryName)/sizeof(mmSymmetryName[0])) ; i++)
+    if (strcasecmp(symmetry, mmSymmetryName[i]) == 0)
+      return (enum mmSymmetry_t)i;
+
+  mm_error(filename, "unknown symmetry qualifier");
+  return MM_GENERAL;
+}
+
+/* Number of data lines in [p, end) */
+static UINT_t mm_count_entries(const char *p, const char *end) {
+  UINT_t count = 0;
+  while (p < end) {
+    p = skip_blanks(p, end);
+    if ((p < end) && IS_DIGIT(*p))
+      count++;
+    p = next_line(p, end);
+  }
+  return count;
+}
+
+/* Parse the data lines in [p, end) into edge keys for both directions of
+   each undirected edge. A symmetric file stores each off-diagonal entry once, so mirroring it
+   here restores the full pattern exactly once; a general file may also list
+   the reverse entry, and that duplicate is removed after sorting. Self-loops
+   are dropped, as in create_graph_RMAT(). Anything after the second column
+   (the value of real, integer or complex entries) is skipped. */
+static enum mmError_t mm_parse_entries(const char *p, const char *end, const uint64_t n, const int shift, uint64_t *keys, UINT_t *numEdges) {
+  UINT_t k = 0;
+  enum mmError_t err = MM_OK;
+
+  while (p < end) {
+    uint64_t row, col;
+    p = skip_blanks(p, end);
+    if ((p < end) && IS_DIGIT(*p)) {
+      p = parse_uint(p, end, &row);
+      p = parse_uint(skip_blanks(p, end), end, &col);
+      if (p == NULL) {
+	err = MM_BAD_ENTRY;
+	break;
+      }
+      if ((row == 0) || (col == 0) || (row > n) || (col > n)) {
+	err = MM_OUT_OF_RANGE;
+	break;
+      }
+      if (row != col) {
+	keys[k  ] = EDGE_KEY(row - 1, col - 1, shift);
+	keys[k+1] = EDGE_KEY(col - 1, row - 1, shift);
+	k += 2;
+      }
+    }
+    p = next_line(p, end);
+  }
+
+  *numEdges = k;
+  return err;
+}
+
+void readMatrixMarketFile(const char *filename, GRAPH_TYPE* graph) {
+  struct stat st;
+  uint64_t num_rows, num_cols, num_entries;
+  enum mmSymmetry_t symmetry = MM_GENERAL;
+  double parse_time;
+  int numThreads = 1;
+
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) {
+    printf("Error opening file %s.\n", filename);
+    exit(1);
+  }
+  if ((fstat(fd, &st) != 0) || (st.st_size == 0))
+    mm_error(filename, "empty or unreadable file");
+
+  parse_time = get_seconds();
+
+  const size_t len = (size_t)st.st_size;
+  const char *buf = (const char *)mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (buf == MAP_FAILED) {
+    perror("mmap");
+    exit(1);
+  }
+  madvise((void *)buf, len, MADV_SEQUENTIAL);
+
+  const char *end = buf + len;
+  const char *p = buf;
+
+  if ((len > 14) && (strncmp(p, "%%MatrixMarket", 14) == 0))
+    symmetry = mm_read_banner(filename, p, end);
+
+  // Skip the comment and blank lines
+  for (p = skip_blanks(p, end) ; (p < end) && !IS_DIGIT(*p) ; p = skip_blanks(p, end)) {
+    if ((*p != '%') && (*p != '\n'))
+      mm_error(filename, "bad size line");
+    p = next_line(p, end);
+  }
+
+  p = parse_uint(p, end, &num_rows);
+  if (p != NULL) p = parse_uint(skip_blanks(p, end), end, &num_cols);
+  if (p != NULL) p = parse_uint(skip_blanks(p, end), end, &num_entries);
+  if (p == NULL)
+    mm_error(filename, "bad size line");
+
+  if (num_rows != num_cols) {
+    fprintf(stderr,"ERROR: Matrix Market input file is not square: rows: %lu  cols: %lu  nnz: %lu\n",
+	    num_rows, num_cols, num_entries);
+    exit(-1);
+  }
+  /* Vertex IDs must fit VERTEX_t and the 32-bit halves of an edge key */
+  if ((num_rows > min((uint64_t)((VERTEX_t)-1) - 1, (uint64_t)UINT32_MAX)) ||
+      (2*num_entries > (uint64_t)((UINT_t)-1)))
+    mm_error(filename, "graph is too large for this build (see WIDE in the Makefile)");
+
+#if DEBUG
+  printf("readMatrixMarketFile: %lu %lu %lu\n",num_rows, num_cols, num_entries);
+#endif
+
+  const char *data = next_line(p, end);
+
+  /* Split the data section into one chunk per thread, on line boundaries */
+#ifdef PARALLEL
+  numThreads = omp_get_max_threads();
+#endif
+  const char **chunk = (const char **)malloc((numThreads + 1) * sizeof(const char *));
+  assert_malloc(chunk);
+  UINT_t *chunkEntries = (UINT_t *)calloc(numThreads + 1, sizeof(UINT_t));
+  assert_malloc(chunkEntries);
+  UINT_t *chunkEdges = (UINT_t *)calloc(numThreads, sizeof(UINT_t));
+  assert_malloc(chunkEdges);
+
+  chunk[0] = data;
+  for (int t = 1 ; t < numThreads ; t++) {
+    const char *q = data + (size_t)(end - data) / numThreads * t;
+    if ((q > data) && (q[-1] != '\n'))
+      q = next_line(q, end);
+    chunk[t] = (q < chunk[t-1]) ? chunk[t-1] : q;
+  }
+  chunk[numThreads] = end;
+
+  /* Pass 1: count the entries of each chunk so each thread knows where to write */
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static,1) num_threads(numThreads)
+#endif
+  for (int t = 0 ; t < numThreads ; t++)
+    chunkEntries[t+1] = mm_count_entries(chunk[t], chunk[t+1]);
+
+  for (int t = 0 ; t < numThreads ; t++)
+    chunkEntries[t+1] += chunkEntries[t];
+
+  if (chunkEntries[numThreads] != num_entries)
+    mm_error(filename, "number of entries does not match the size line");
+
+  const int shift = edge_key_shift((UINT_t)num_rows);
+  uint64_t* keys = (uint64_t*)malloc((2*num_entries + 1) * sizeof(uint64_t));
+  assert_malloc(keys);
+
+  /* Pass 2: parse each chunk in place */
+  int err = MM_OK;
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static,1) num_threads(numThreads) reduction(max:err)
+#endif
+  for (int t = 0 ; t < numThreads ; t++)
+    err = max(err, (int)mm_parse_entries(chunk[t], chunk[t+1], num_rows, shift, keys + 2*chunkEntries[t], &chunkEdges[t]));
+
+  if (err == MM_BAD_ENTRY) {
+    fprintf(stderr,"Invalid Matrix Market file: bad entry.\n");
+    exit(8);
+  }
+  if (err == MM_OUT_OF_RANGE) {
+    fprintf(stderr,"Invalid Matrix Market file: entry out of range.\n");
+    exit(8);
+  }
+
+  /* Close the gaps left by self-loops */
+  UINT_t edgeCount = 0;
+  for (int t = 0 ; t < numThreads ; t++) {
+    if (edgeCount != 2*chunkEntries[t])
+      memmove(keys + edgeCount, keys + 2*chunkEntries[t], chunkEdges[t] * sizeof(uint64_t));
+    edgeCount += chunkEdges[t];
+  }
+
+  parse_time = get_seconds() - parse_time;
+
+  munmap((void *)buf, len);
+  close(fd);
+
+  free(chunkEdges);
+  free(chunkEntries);
+  free(chunk);
+
+  if (!QUIET)
+    printf("Matrix Market (%s): %lu entries, %.1f MB parsed in %9.6f s (%.1f MB/s, %d threads)\n",
+	   mmSymmetryName[symmetry], num_entries, (double)len / 1.0e6, parse_time,
+	   (double)len / 1.0e6 / parse_time, numThreads);
+
+  uint64_t* keysNoDup = (uint64_t*)malloc((edgeCount + 1) * sizeof(uint64_t));
+  assert_malloc(keysNoDup);
+
+  radix_sort_u64(keys, keysNoDup, edgeCount, 2*shift);
+  UINT_t edgeCountNoDup = unique_u64(keys, keysNoDup, edgeCount);
+
+  graph->numVertices = num_rows;
+  graph->numEdges = edgeCountNoDup;
+  allocate_graph(graph);
+
+  convert_edges_to_graph(keysNoDup, shift, true, graph);
+
+  free(keysNoDup);
+  free(keys);
+
+  return;
+}
+
+
+/* Binary CSR snapshots.
+
+   Layout: a csrHeader_t at offset 0, followed by the rowPtr[] and colInd[]
+   sections of GRAPH_TYPE, each starting on a CSR_ALIGN boundary so that the
+   sections can be used in place from a read-only mapping of the file. */
+
+#define CSR_BYTE_ORDER      0x01020304
+#define CSR_CHECKSUM_BLOCK  (1 << 20)
+#define CSR_ROUNDUP(x)      ((((x) + CSR_ALIGN - 1) / CSR_ALIGN) * CSR_ALIGN)
+
+static void *csrMap = NULL;
+static size_t csrMapLen = 0;
+
+static INLINE uint64_t mix64(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+static uint64_t csr_checksum_block(const unsigned char *p, const size_t len) {
+  uint64_t h = len, w;
+  size_t i;
+
+  for (i = 0 ; i + sizeof(uint64_t) <= len ; i += sizeof(uint64_t)) {
+    memcpy(&w, p + i, sizeof(uint64_t));
+    h = (h ^ w) * 0x9e3779b97f4a7c15ULL;
+  }
+  if (i < len) {
+    w = 0;
+    memcpy(&w, p + i, len - i);
+    h = (h ^ w) * 0x9e3779b97f4a7c15ULL;
+  }
+  return mix64(h);
+}
+
+/* Checksum of a section. The blocks have a fixed size and are combined with
+   their index, so the result does not depend on the number of threads. */
+static uint64_t csr_checksum(const void *data, const size_t len) {
+  const unsigned char *p = (const unsigned char *)data;
+  const size_t numBlocks = (len + CSR_CHECKSUM_BLOCK - 1) / CSR_CHECKSUM_BLOCK;
+  uint64_t sum = mix64(len);
+
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static) reduction(+:sum)
+#endif
+  for (size_t b = 0 ; b < numBlocks ; b++) {
+    const size_t s = b * CSR_CHECKSUM_BLOCK;
+    const size_t l = min((size_t)CSR_CHECKSUM_BLOCK, len - s);
+    sum += mix64(csr_checksum_block(p + s, l) + b);
+  }
+  return sum;
+}
+
+static void csr_error(const char *filename, const char *msg) {
+  fprintf(stderr,"ERROR: CSR file %s: %s\n", filename, msg);
+  exit(8);
+}
+
+static void csr_fwrite(const char *filename, FILE *f, const void *data, const size_t len, const size_t pad) {
+  static const char zeros[CSR_ALIGN];
+
+  if ((len > 0) && (fwrite(data, 1, len, f) != len))
+    csr_error(filename, "write failed");
+  if ((pad > 0) && (fwrite(zeros, 1, pad, f) != pad))
+    csr_error(filename, "write failed");
+}
+
+bool isCSRFile(const char *filename) {
+  char magic[8];
+  FILE *f = fopen(filename, "rb");
+  if (f == NULL) return false;
+  size_t len = fread(magic, 1, sizeof(magic), f);
+  fclose(f);
+  return (len == sizeof(magic)) && (memcmp(magic, CSR_MAGIC, sizeof(magic)) == 0);
+}
+
+void writeCSRFile(const char *filename, const GRAPH_TYPE *graph) {
+  csrHeader_t header;
+  double write_time = get_seconds();
+
+  const uint64_t n = graph->numVertices;
+  const uint64_t m = graph->numEdges;
+  const size_t rowPtrBytes = (n + 1) * sizeof(UINT_t);
+  const size_t colIndBytes = m * sizeof(VERTEX_t);
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, CSR_MAGIC, sizeof(header.magic));
+  header.version = CSR_VERSION;
+  header.uintSize = sizeof(UINT_t);
+  header.vertexSize = sizeof(VERTEX_t);
+  header.byteOrder = CSR_BYTE_ORDER;
+  header.numVertices = n;
+  header.numEdges = m;
+  header.rowPtrOffset = CSR_ROUNDUP(sizeof(csrHeader_t));
+  header.colIndOffset = CSR_ROUNDUP(header.rowPtrOffset + rowPtrBytes);
+  header.rowPtrChecksum = csr_checksum(graph->rowPtr, rowPtrBytes);
+  header.colIndChecksum = csr_checksum(graph->colInd, colIndBytes);
+  header.headerChecksum = csr_checksum(&header, offsetof(csrHeader_t, headerChecksum));
+
+  FILE *f = fopen(filename, "wb");
+  if (f == NULL)
+    csr_error(filename, "could not open for writing");
+
+  csr_fwrite(filename, f, &header, sizeof(header), header.rowPtrOffset - sizeof(header));
+  csr_fwrite(filename, f, graph->rowPtr, rowPtrBytes, header.colIndOffset - header.rowPtrOffset - rowPtrBytes);
+  csr_fwrite(filename, f, graph->colInd, colIndBytes, 0);
+
+  if (fclose(f) != 0)
+    csr_error(filename, "write failed");
+
+  write_time = get_seconds() - write_time;
+
+  if (!QUIET)
+    printf("CSR snapshot %s: %.1f MB written in %9.6f s\n",
+	   filename, (double)(header.colIndOffset + colIndBytes) / 1.0e6, write_time);
+}
+
+/* Map a snapshot read-only and point graph->rowPtr/colInd straight into the
+   mapping. The graph must be released with unmapCSRFile(), not free_graph(). */
+void readCSRFile(const char *filename, GRAPH_TYPE *graph, const int flags) {
+  struct stat st;
+  int mapFlags = MAP_SHARED;
+  double map_time;
+
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) {
+    printf("Error opening file %s.\n", filename);
+    exit(1);
+  }
+  if ((fstat(fd, &st) != 0) || ((size_t)st.st_size < sizeof(csrHeader_t)))
+    csr_error(filename, "file is too short");
+
+  map_time = get_seconds();
+
+#ifdef MAP_POPULATE
+  if (flags & CSR_MAP_POPULATE)
+    mapFlags |= MAP_POPULATE;
+#endif
+
+  const size_t len = (size_t)st.st_size;
+  void *map = mmap(NULL, len, PROT_READ, mapFlags, fd, 0);
+  if (map == MAP_FAILED) {
+    perror("mmap");
+    exit(1);
+  }
+  close(fd);
+
+  if (flags & CSR_MAP_HUGE) {
+#ifdef MADV_HUGEPAGE
+    if ((madvise(map, len, MADV_HUGEPAGE) != 0) && !QUIET)
+      fprintf(stderr,"WARNING: huge pages are not available for %s\n", filename);
+#else
+    if (!QUIET)
+      fprintf(stderr,"WARNING: huge pages are not supported on this system\n");
+#endif
+  }
+
+  const csrHeader_t *header = (const csrHeader_t *)map;
+  const char *base = (const char *)map;
+
+  if (memcmp(header->magic, CSR_MAGIC, sizeof(header->magic)) != 0)
+    csr_error(filename, "bad magic number");
+  if (header->version != CSR_VERSION)
+    csr_error(filename, "unsupported version");
+  if (header->byteOrder != CSR_BYTE_ORDER)
+    csr_error(filename, "written on a machine with a different byte order");
+  if (header->uintSize != sizeof(UINT_t)) {
+    fprintf(stderr,"ERROR: CSR file %s: written with a %u-byte UINT_t, this build uses %zu bytes\n",
+	    filename, header->uintSize, sizeof(UINT_t));
+    exit(8);
+  }
+  const uint32_t vertexSize = (header->vertexSize == 0) ? header->uintSize : header->vertexSize;
+  if (vertexSize != sizeof(VERTEX_t)) {
+    fprintf(stderr,"ERROR: CSR file %s: written with a %u-byte VERTEX_t, this build uses %zu bytes\n",
+	    filename, vertexSize, sizeof(VERTEX_t));
+    exit(8);
+  }
+  if (header->headerChecksum != csr_checksum(header, offsetof(csrHeader_t, headerChecksum)))
+    csr_error(filename, "header checksum mismatch");
+
+  const uint64_t n = header->numVertices;
+  const uint64_t m = header->numEdges;
+  const size_t rowPtrBytes = (n + 1) * sizeof(UINT_t);
+  const size_t colIndBytes = m * sizeof(VERTEX_t);
+
+  if ((header->rowPtrOffset % CSR_ALIGN) || (header->colIndOffset % CSR_ALIGN) ||
+      (header->rowPtrOffset + rowPtrBytes > header->colIndOffset) ||
+      (header->colIndOffset + colIndBytes > len))
+    csr_error(filename, "truncated or corrupt section table");
+
+  if (!(flags & CSR_NO_VERIFY)) {
+    if (header->rowPtrChecksum != csr_checksum(base + header->rowPtrOffset, rowPtrBytes))
+      csr_error(filename, "rowPtr checksum mismatch");
+    if (header->colIndChecksum != csr_checksum(base + header->colIndOffset, colIndBytes))
+      csr_error(filename, "colInd checksum mismatch");
+  }
+
+  graph->numVertices = (UINT_t)n;
+  graph->numEdges = (UINT_t)m;
+  graph->rowPtr = (UINT_t *)(base + header->rowPtrOffset);
+  graph->colInd = (VERTEX_t *)(base + header->colIndOffset);
+
+  if ((graph->rowPtr[0] != 0) || (graph->rowPtr[n] != m))
+    csr_error(filename, "inconsistent rowPtr");
+
+  csrMap = map;
+  csrMapLen = len;
+
+  map_time = get_seconds() - map_time;
+
+  if (!QUIET)
+    printf("CSR snapshot %s: %.1f MB mapped in %9.6f s%s%s%s\n",
+	   filename, (double)len / 1.0e6, map_time,
+	   (flags & CSR_MAP_POPULATE) ? ", populated" : "",
+	   (flags & CSR_MAP_HUGE) ? ", huge pages" : "",
+	   (flags & CSR_NO_VERIFY) ? ", not verified" : ", verified");
+}
+
+void unmapCSRFile(GRAPH_TYPE *graph) {
+  if (csrMap != NULL)
+    munmap(csrMap, csrMapLen);
+  csrMap = NULL;
+  csrMapLen = 0;
+  free(graph);
+}
@@ -0,0 +1,36 @@
+#ifndef _IO_H
+#define _IO_H
+
+void readMatrixMarketFile(const char *, GRAPH_TYPE *);
+
+/* Binary CSR snapshot (.csr) */
+#define CSR_MAGIC     "TCCSR\0\0\0"
+#define CSR_VERSION   1
+#define CSR_ALIGN     4096
+
+/* readCSRFile flags */
+#define CSR_MAP_POPULATE  0x1
+#define CSR_MAP_HUGE      0x2
+#define CSR_NO_VERIFY     0x4
+
+typedef struct {
+  char     magic[8];
+  uint32_t version;
+  uint32_t uintSize;        /* sizeof(UINT_t) of the writer */
+  uint32_t byteOrder;       /* 0x01020304 as written by the writer */
+  uint32_t vertexSize;      /* sizeof(VERTEX_t) of the writer, 0 if the same as uintSize */
+  uint64_t numVertices;
+  uint64_t numEdges;
+  uint64_t rowPtrOffset;    /* byte offsets of the sections, CSR_ALIGN aligned */
+  uint64_t colIndOffset;
+  uint64_t rowPtrChecksum;
+  uint64_t colIndChecksum;
+  uint64_t headerChecksum;  /* over all of the preceding fields */
+} csrHeader_t;
+
+bool isCSRFile(const char *);
+void writeCSRFile(const char *, const GRAPH_TYPE *);
+void readCSRFile(const char *, GRAPH_TYPE *, const int);
+void unmapCSRFile(GRAPH_TYPE *);
+
+#endif
@@ -0,0 +1,178 @@
+#include "types.h"
+#include "graph.h"
+#include "tc.h"
+#ifdef PARALLEL
+#include "tc_parallel.h"
+#endif
+#include "auto.h"
+#include "kernels.h"
+#include <fnmatch.h>
+
+/* tc_fast_llm is defined by the llm_variants; a standalone tc has none,
+   and the weak reference leaves its entry NULL */
+#pragma weak tc_fast_llm
+
+/* Heap footprint models { per vertex, per adjacency entry, per vertex and
+   thread }, following the allocations of the kernels and erring on the
+   large side. A degree order adds the relabeled copy of the graph and
+   its permutation arrays. tc_fast_llm differs between the variants and
+   is never refused. */
+#define MEM_U  ((double)sizeof(UINT_t))
+#define MEM_V  ((double)sizeof(VERTEX_t))
+#define MEM_MI ((double)MARK_BYTES(MARK_INTERSECT))   /* per vertex of the markers (mark.h) */
+#define MEM_MB ((double)MARK_BYTES(MARK_BADER))
+
+#define MEM_NONE           { 0, 0, 0 }
+#define MEM_UNKNOWN        { 0, 0, 0 }
+#define MEM_MARK           { MEM_MI, 0, 0 }
+#define MEM_DAVIS          { MARK_BYTES(MARK_DAVIS), 0, 0 }
+#define MEM_MARK_P         { 0, 0, MEM_MI }
+#define MEM_FORWARD        { MEM_U, MEM_U, 0 }
+#define MEM_FORWARD_HASH   { MEM_U + MEM_MI, MEM_U, 0 }
+#define MEM_FORWARD_DO     { 5*MEM_U + MEM_MI, MEM_U + MEM_V, 0 }
+#define MEM_BFS            { 2*MEM_U + 1, 0, 0 }
+#define MEM_BFS_HASH       { 2*MEM_U + 1 + MEM_MB, 0, 0 }
+#define MEM_BFS_HORIZ      { 2*MEM_U + 1 + MEM_MB, 1, 0 }
+#define MEM_BFS_HORIZ_DO   { 6*MEM_U + 1 + MEM_MB, MEM_V + 1, 0 }
+#define MEM_BFS_SPLIT      { 4*MEM_U + 1 + MEM_MB + MEM_MI, 2*MEM_V + MEM_U + 1, 0 }
+#define MEM_BFS_SPLIT_DO   { 8*MEM_U + 1 + MEM_MB + MEM_MI, 3*MEM_V + MEM_U + 1, 0 }
+#define MEM_BFS_RECURSIVE  { 8*MEM_U + 4, 4*MEM_V + 2*MEM_U + 4, 0 }   /* two levels of recursion */
+#define MEM_BFS_HYBRID     { 3*MEM_U + 2, MEM_U + 2, 0 }
+#define MEM_TREELIST       { 2*MEM_U + 2, 1, 0 }
+#define MEM_TREELIST2      { 4*MEM_U + 2, MEM_V + 1, 0 }
+#define MEM_BFS_HORIZ_P    { 2*MEM_U + 1, 1, MEM_MB }
+#define MEM_BFS_CORE_P     { 2*MEM_U + 1, 0, MEM_MB }
+#define MEM_BFS_FRONTIER_P { 3*MEM_U + 1, 0, MEM_MB }
+#define MEM_MAPJIK_P       { 2*MEM_U + 16, 4, 0 }
+#define MEM_FORWARD_P      { MEM_U + 8, MEM_V / 2, 0 }
+#define MEM_FORWARD_MARK_P { MEM_U + 8, MEM_V / 2, MARK_BYTES(MARK_FORWARD) }
+#define MEM_AUTO           MEM_BFS_SPLIT                        /* the largest candidate */
+#define MEM_AUTO_P         { 2*MEM_U + 16, MEM_U + 1, max(MEM_MI, max(MEM_MB, MARK_BYTES(MARK_FORWARD))) }   /* the largest of each term */
+
+/* Every benchmarked kernel, in the order they are run */
+const kernel_t kernels[] = {
+  { "tc_wedge",                        tc_wedge,                           false, KC_WEDGE,     PRE_NONE,                                MEM_NONE           },
+  { "tc_wedge_DO",                     tc_wedge_DO,                        false, KC_WEDGE,     PRE_NONE,                                MEM_NONE           },
+  { "tc_intersect_MergePath",          tc_intersectMergePath,              false, KC_INTERSECT, PRE_NONE,                                MEM_NONE           },
+  { "tc_intersect_MergePath_DO",       tc_intersectMergePath_DO,           false, KC_INTERSECT, PRE_NONE,                                MEM_NONE           },
+  { "tc_intersect_BinarySearch",       tc_intersectBinarySearch,           false, KC_INTERSECT, PRE_NONE,                                MEM_NONE           },
+  { "tc_intersect_BinarySearch_DO",    tc_intersectBinarySearch_DO,        false, KC_INTERSECT, PRE_NONE,                                MEM_NONE           },
+  { "tc_intersect_Partition",          tc_intersectPartition,              false, KC_INTERSECT, PRE_NONE,                                MEM_NONE           },
+  { "tc_intersect_Partition_DO",       tc_intersectPartition_DO,           false, KC_INTERSECT, PRE_NONE,                                MEM_NONE           },
+  { "tc_intersect_Hash",               tc_intersectHash,                   false, KC_INTERSECT, PRE_NONE,                                MEM_MARK           },
+  { "tc_intersect_Hash_DO",            tc_intersectHash_DO,                false, KC_INTERSECT, PRE_NONE,                                MEM_MARK           },
+  { "tc_intersect_Adaptive",           tc_intersectAdaptive,               false, KC_INTERSECT, PRE_NONE,                                MEM_MARK           },
+  { "tc_intersect_Adaptive_DO",        tc_intersectAdaptive_DO,            false, KC_INTERSECT, PRE_NONE,                                MEM_MARK           },
+  { "tc_forward",                      tc_forward,                         false, KC_FORWARD,   PRE_ORIENT,                              MEM_FORWARD        },
+  { "tc_forward_adaptive",             tc_forward_adaptive,                false, KC_FORWARD,   PRE_ORIENT,                              MEM_FORWARD_HASH   },
+  { "tc_forward_hash",                 tc_forward_hash,                    false, KC_FORWARD,   PRE_ORIENT,                              MEM_FORWARD_HASH   },
+  { "tc_forward_hash_skip",            tc_forward_hash_skip,               false, KC_FORWARD,   PRE_ORIENT,                              MEM_FORWARD_HASH   },
+  { "tc_forward_hash_degreeOrder",     tc_forward_hash_degreeOrder,        false, KC_FORWARD,   PRE_DEGREE_ORDER | PRE_ORIENT,           MEM_FORWARD_DO     },
+  { "tc_forward_hash_degreeOrderRev",  tc_forward_hash_degreeOrderReverse, false, KC_FORWARD,   PRE_DEGREE_ORDER | PRE_ORIENT,           MEM_FORWARD_DO     },
+  { "tc_compact_forward",              tc_compact_forward,                 false, KC_FORWARD,   PRE_DEGREE_ORDER | PRE_ORIENT,           MEM_FORWARD_DO     },
+  { "tc_fast_llm",                     tc_fast_llm,                        false, KC_VARIES,    PRE_NONE,                                MEM_UNKNOWN        },
+  { "tc_davis",                        tc_davis,                           false, KC_WEDGE,     PRE_NONE,                                MEM_DAVIS          },
+  { "tc_low",                          tc_low,                             false, KC_WEDGE,     PRE_NONE,                                MEM_NONE           },
+  { "tc_bader",                        tc_bader,                           false, KC_BFS,       PRE_BFS,                                 MEM_BFS            },
+  { "tc_bader2",                       tc_bader2,                          false, KC_BFS,       PRE_BFS,                                 MEM_BFS            },
+  { "tc_bader3",                       tc_bader3,                          false, KC_BFS,       PRE_BFS,                                 MEM_BFS_HASH       },
+  { "tc_bader4",                       tc_bader4,                          false, KC_BFS,       PRE_BFS,                                 MEM_BFS_HORIZ      },
+  { "tc_bader5",                       tc_bader5,                          false, KC_BFS,       PRE_BFS,                                 MEM_BFS_HORIZ      },
+  { "tc_bader4_degreeOrder",           tc_bader4_degreeOrder,              false, KC_BFS,       PRE_BFS | PRE_DEGREE_ORDER,              MEM_BFS_HORIZ_DO   },
+  { "tc_bader_forward_hash",           tc_bader_forward_hash,              false, KC_BFS,       PRE_BFS | PRE_ORIENT,                    MEM_BFS_SPLIT      },
+  { "tc_bader_forward_hash_degOrd",    tc_bader_forward_hash_degreeOrder,  false, KC_BFS,       PRE_BFS | PRE_DEGREE_ORDER | PRE_ORIENT, MEM_BFS_SPLIT_DO   },
+  { "tc_bader_recursive",              tc_bader_recursive,                 false, KC_BFS,       PRE_BFS,                                 MEM_BFS_RECURSIVE  },
+  { "tc_bader_hybrid",                 tc_bader_hybrid,                    false, KC_BFS,       PRE_BFS,                                 MEM_BFS_HYBRID     },
+  { "tc_bader_new_bfs",                tc_bader_new_bfs,                   false, KC_BFS,       PRE_BFS,                                 MEM_BFS_HASH       },
+  { "tc_treelist",                     tc_treelist,                        false, KC_FORWARD,   PRE_SPANNING_TREE,                       MEM_TREELIST       },
+  { "tc_treelist2",                    tc_treelist2,                       false, KC_FORWARD,   PRE_SPANNING_TREE,                       MEM_TREELIST2      },
+  { "tc_auto",                         tc_auto,                            false, KC_VARIES,    PRE_NONE,                                MEM_AUTO           },
+  { "tc_triples",                      tc_triples,                         false, KC_CUBIC,     PRE_NONE,                                MEM_NONE           },
+  { "tc_triples_DO",                   tc_triples_DO,                      false, KC_CUBIC,     PRE_NONE,                                MEM_NONE           },
+#ifdef PARALLEL
+  { "tc_wedge_P",                      tc_wedge_P,                         true,  KC_WEDGE,     PRE_NONE,                                MEM_NONE           },
+  { "tc_wedge_DO_P",                   tc_wedge_DO_P,                      true,  KC_WEDGE,     PRE_NONE,                                MEM_NONE           },
+  { "tc_intersect_MergePath_P",        tc_intersectMergePath_P,            true,  KC_INTERSECT, PRE_NONE,                                MEM_NONE           },
+  { "tc_intersect_MergePath_DO_P",     tc_intersectMergePath_DO_P,         true,  KC_INTERSECT, PRE_NONE,                                MEM_NONE           },
+  { "tc_intersect_BinarySearch_P",     tc_intersectBinarySearch_P,         true,  KC_INTERSECT, PRE_NONE,                                MEM_NONE           },
+  { "tc_intersect_BinarySearch_DO_P",  tc_intersectBinarySearch_DO_P,      true,  KC_INTERSECT, PRE_NONE,                                MEM_NONE           },
+  { "tc_intersect_Partition_P",        tc_intersectPartition_P,            true,  KC_INTERSECT, PRE_NONE,                                MEM_NONE           },
+  { "tc_intersect_Partition_DO_P",     tc_intersectPartition_DO_P,         true,  KC_INTERSECT, PRE_NONE,                                MEM_NONE           },
+  { "tc_intersect_Hash_P",             tc_intersectHash_P,                 true,  KC_INTERSECT, PRE_NONE,                                MEM_MARK_P         },
+  { "tc_intersect_Hash_DO_P",          tc_intersectHash_DO_P,              true,  KC_INTERSECT, PRE_NONE,                                MEM_MARK_P         },
+  { "tc_intersect_Adaptive_P",         tc_intersectAdaptive_P,             true,  KC_INTERSECT, PRE_NONE,                                MEM_MARK_P         },
+  { "tc_intersect_Adaptive_DO_P",      tc_intersectAdaptive_DO_P,          true,  KC_INTERSECT, PRE_NONE,                                MEM_MARK_P         },
+  { "tc_bader_bfs1_P",                 tc_bader_bfs1_P,                    true,  KC_BFS,       PRE_BFS,                                 MEM_BFS_HORIZ_P    },
+  { "tc_bader_bfs3_P",                 tc_bader_bfs3_P,                    true,  KC_BFS,       PRE_BFS,                                 MEM_BFS_CORE_P     },
+  { "tc_bader_bfs_visited_P",          tc_bader_bfs_visited_P,             true,  KC_BFS,       PRE_BFS,                                 MEM_BFS_CORE_P     },
+  { "tc_bader_bfs_hybrid_P",           tc_bader_bfs_hybrid_P,              true,  KC_BFS,       PRE_BFS,                                 MEM_BFS_FRONTIER_P },
+  { "tc_bader_bfs_hybrid2_P",          tc_bader_bfs_hybrid2_P,             true,  KC_BFS,       PRE_BFS,                                 MEM_BFS_FRONTIER_P },
+  { "tc_bader_bfs_chatgpt_P",          tc_bader_bfs_chatgpt_P,             true,  KC_BFS,       PRE_BFS,                                 MEM_BFS_CORE_P     },
+  { "tc_bader_bfs_locks_P",            tc_bader_bfs_locks_P,               true,  KC_BFS,       PRE_BFS,                                 MEM_BFS_FRONTIER_P },
+  { "tc_MapJIK_P",                     tc_MapJIK_P,                        true,  KC_FORWARD,   PRE_DEGREE_ORDER | PRE_ORIENT,           MEM_MAPJIK_P       },
+  { "tc_forward_hash_P",               tc_forward_hash_P,                  true,  KC_FORWARD,   PRE_ORIENT,                              MEM_FORWARD_MARK_P },
+  { "tc_forward_merge_P",              tc_forward_merge_P,                 true,  KC_FORWARD,   PRE_ORIENT,                              MEM_FORWARD_P      },
+  { "tc_auto_P",                       tc_auto_P,                          true,  KC_VARIES,    PRE_NONE,                                MEM_AUTO_P         },
+  { "tc_triples_P",                    tc_triples_P,                       true,  KC_CUBIC,     PRE_NONE,                                MEM_NONE           },
+  { "tc_triples_DO_P",                 tc_triples_DO_P,                    true,  KC_CUBIC,     PRE_NONE,                                MEM_NONE           },
+#endif
+};
+
+const int numKernels = sizeof(kernels) / sizeof(kernels[0]);
+
+static const char *kernelClassName[] = { "O(n^3)", "O(sum d^2)", "O(m*dmax)", "O(m*dmax) on BFS", "O(m^1.5)", "varies" };
+
+const char *kernel_class_name(const enum kernelClass_t c) {
+  return kernelClassName[c];
+}
+
+/* A kernel is selected if its name matches one of the comma separated
+   glob patterns, or if there are none. The N^3 kernels are left out by -x,
+   and a kernel missing from this build is never selected. */
+bool kernel_selected(const kernel_t *kernel, const char *patterns) {
+  if (kernel->f == NULL)
+    return false;
+  if ((kernel->complexity == KC_CUBIC) && !NCUBED)
+    return false;
+  if (patterns == NULL)
+    return true;
+
+  const char *p = patterns;
+  while (*p) {
+    const char *q = strchr(p, ',');
+    const size_t len = (q == NULL) ? strlen(p) : (size_t)(q - p);
+    char pattern[256];
+    if (len < sizeof(pattern)) {
+      memcpy(pattern, p, len);
+      pattern[len] = '\0';
+      if (fnmatch(pattern, kernel->name, 0) == 0)
+	return true;
+    }
+    p += len;
+    if (*p == ',') p++;
+  }
+  return false;
+}
+
+size_t kernel_footprint(const kernel_t *kernel, const GRAPH_TYPE *graph, const int threads) {
+  const double n = (double)graph->numVertices;
+  const double m = (double)graph->numEdges;
+  return (size_t)(kernel->memory.vertex * n + kernel->memory.edge * m +
+		  kernel->memory.threadVertex * n * (double)threads);
+}
+
+void list_kernels(FILE *outfile) {
+  fprintf(outfile,"%-32s %-9s %-18s %s\n", "Kernel", "Type", "Complexity", "Preprocessing");
+  for (int k = 0 ; k < numKernels ; k++) {
+    const kernel_t *kernel = &kernels[k];
+    char pre[64] = "";
+    if (kernel->f == NULL) continue;
+    if (kernel->preprocess & PRE_BFS) strcat(pre, "bfs ");
+    if (kernel->preprocess & PRE_DEGREE_ORDER) strcat(pre, "degree-order ");
+    if (kernel->preprocess & PRE_ORIENT) strcat(pre, "orient ");
+    if (kernel->preprocess & PRE_SPANNING_TREE) strcat(pre, "spanning-tree ");
+    if (pre[0] == '\0') strcat(pre, "none");
+    fprintf(outfile,"%-32s %-9s %-18s %s\n", kernel->name, kernel->parallel ? "parallel" : "serial",
+	    kernel_class_name(kernel->complexity), pre);
+  }
+}
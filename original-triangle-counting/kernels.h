@@ -0,0 +1,39 @@
+#ifndef _KERNELS_H
+#define _KERNELS_H
+
+/* Asymptotic cost class of a kernel */
+enum kernelClass_t { KC_CUBIC = 0, KC_WEDGE, KC_INTERSECT, KC_BFS, KC_FORWARD, KC_VARIES };
+
+/* Preprocessing done by a kernel before it counts (bit mask) */
+#define PRE_NONE           0x0
+#define PRE_BFS            0x1   /* BFS levels and horizontal edges */
+#define PRE_DEGREE_ORDER   0x2   /* vertices relabeled by degree */
+#define PRE_ORIENT         0x4   /* oriented (s < t) copy of the adjacency lists */
+#define PRE_SPANNING_TREE  0x8   /* repeated spanning tree removal */
+
+/* Predicted heap footprint of a kernel, in bytes per vertex, per
+   adjacency list entry (numEdges) and per vertex and thread */
+typedef struct {
+  double vertex;
+  double edge;
+  double threadVertex;
+} memModel_t;
+
+typedef struct {
+  const char *name;
+  UINT_t (*f)(const GRAPH_TYPE *);
+  bool parallel;
+  enum kernelClass_t complexity;
+  int preprocess;
+  memModel_t memory;
+} kernel_t;
+
+extern const kernel_t kernels[];
+extern const int numKernels;
+
+const char *kernel_class_name(const enum kernelClass_t);
+bool kernel_selected(const kernel_t *, const char *);
+size_t kernel_footprint(const kernel_t *, const GRAPH_TYPE *, const int);
+void list_kernels(FILE *);
+
+#endif
@@ -2,6 +2,18 @@
 #include "queue.h"
 #include "graph.h"
 #include "bfs.h"
+#include "io.h"
+#include "gen.h"
+#include "intersect.h"
+#include "hub.h"
+#include "oracle.h"
+#include "auto.h"
+#include "kernels.h"
+#include "perf.h"
+#include "phase.h"
+#include "placement.h"
+#include "plugin.h"
+#include "report.h"
 #include "tc.h"
 #ifdef PARALLEL
 #include "tc_parallel.h"
@@ -15,48 +27,138 @@
 #endif
 #define SCALE_MIN       6
 #define DEBUG           0
+#define MIB             1048576.0
 
 bool QUIET  = false;
 bool PRINT  = false;
 bool NCUBED = true;
 
+#ifdef PHASE_TIMERS
+double phaseTime[PHASE_NUM];
+double phaseMark;
+#endif
+
 #ifdef PARALLEL
 bool BENCHMARK_BFS = false;
 bool PARALLEL_MAX = false;
 int  PARALLEL_PROCS = 0;
+
+/* Thread counts of a scaling sweep (-p list or -S), ascending */
+#define MAX_THREAD_COUNTS  64
+static int THREAD_COUNTS[MAX_THREAD_COUNTS];
+static int NUM_THREAD_COUNTS = 0;
 #endif
 
 
-static void benchmarkTC(UINT_t (*f)(const GRAPH_TYPE*), const GRAPH_TYPE *, GRAPH_TYPE *, const char *);
+static double benchmarkTC(UINT_t (*f)(const GRAPH_TYPE*), const GRAPH_TYPE *, const char *);
 #ifdef PARALLEL
-static void benchmarkTC_P(UINT_t (*f)(const GRAPH_TYPE*), const GRAPH_TYPE *, GRAPH_TYPE *, const char *);
+static double benchmarkTC_P(UINT_t (*f)(const GRAPH_TYPE*), const GRAPH_TYPE *, const char *, const double);
 #endif
 
 static FILE *infile = NULL, *outfile = NULL;
 static char *INFILENAME = NULL;
+static char *CSRFILENAME = NULL;
+static char *REPORTFILENAME = NULL;
+static int CSR_FLAGS = 0;
+static bool PROTECT = false;
+static enum placement_t PLACEMENT = PLACE_NONE;
+static bool BIND_THREADS = false;
+static bool PERF_COUNTERS = false;
+static enum oracleMode_t ORACLE_MODE = ORACLE_FAST;
+static char *ORACLE_FILENAME = NULL;
+static UINT_t ORACLE_SAMPLES = ORACLE_DEFAULT_SAMPLES;
 static int SCALE = 0;
+static char *GEN_SPEC = NULL;
+static rmatParams_t RMAT_PARAMS = { RMAT_DEFAULT_A, RMAT_DEFAULT_B, RMAT_DEFAULT_C,
+				    1.0 - RMAT_DEFAULT_A - RMAT_DEFAULT_B - RMAT_DEFAULT_C,
+				    RMAT_DEFAULT_SEED, false };
+static char *KERNEL_PATTERNS = NULL;
+static int LOOPS = LOOP_CNT;
+static int WARMUP = 0;
+static size_t MEM_BUDGET = 0;
+static char *CALIBRATE_FILENAME = NULL;
+static char *PROFILE_FILENAME = NULL;
+static char *INTERSECT_ISA = NULL;
+static char *CROSSOVERS = NULL;
+static UINT_t HUBS = 0;
+static size_t HUB_BUDGET = HUB_DEFAULT_BUDGET;
 static bool input_selected = 0;
 
+static double bestSerialTime = 0.0;
+static const char *bestSerialName = NULL;
+
 static void usage(void) {
 
   printf("Triangle Counting\n\n");
   printf("Usage:\n\n");
-  printf("Either one of these two must be selected:\n");
-  printf(" -f <filename>   [Input Graph in Matrix Market format]\n");
+  printf("One of these must be selected:\n");
+  printf(" -f <filename>   [Input Graph in Matrix Market or binary CSR format]\n");
   printf(" -r SCALE        [Use RMAT graph of size SCALE] (SCALE must be >= %d) \n", SCALE_MIN);
+  printf(" -g type:params  [Use a generated graph, one of:]\n");
+  printf(GEN_USAGE);
   printf("Optional arguments:\n");
   printf(" -o <filename>   [Output File]\n");
+  printf(" -O <filename>   [Append per-kernel results as JSON Lines, or CSV for a .csv file]\n");
+  printf(" -w <filename>   [Write the input graph as a binary CSR snapshot]\n");
+  printf(" -m <opts>       [CSR mapping options, comma separated: populate,huge,noverify]\n");
+  printf(" -R              [Keep the input graph in read-only memory (mprotect)]\n");
+  printf(" -N <opts>       [NUMA, comma separated: one of interleave, firsttouch, replicate,\n");
+  printf("                  and bind (bind the threads to CPUs in node order)]\n");
+  printf(" -c <oracle>     [Reference triangle count: fast (default), wedge, none,\n");
+  printf("                  sample[:N] (estimate from N random vertices, default %d),\n", ORACLE_DEFAULT_SAMPLES);
+  printf("                  file[:name] (count stored in name, default <input>.tc)]\n");
+  printf(" -s seed         [Random seed for the generators and oracle sampling] (default %d)\n", RMAT_DEFAULT_SEED);
+  printf(" -k A,B,C[,D]    [RMAT: Quadrant probabilities] (default %.2f,%.2f,%.2f,%.2f)\n",
+	 RMAT_DEFAULT_A, RMAT_DEFAULT_B, RMAT_DEFAULT_C, 1.0 - RMAT_DEFAULT_A - RMAT_DEFAULT_B - RMAT_DEFAULT_C);
+  printf(" -z              [RMAT: Permute the vertex IDs]\n");
 #ifdef PARALLEL
   printf(" -p #            [Parallel: Use # threads/cores]\n");
+  printf(" -p #,#,...      [Parallel: Run each parallel kernel at every thread count, e.g. 1,2,4,8,max]\n");
   printf(" -P              [Parallel: Use maximum number of cores]\n");
+  printf(" -S              [Parallel: Sweep 1,2,4,... threads up to the maximum number of cores]\n");
 #endif
   printf(" -d              [Display/Print Input Graph]\n");
   printf(" -q              [Turn on Quiet mode]\n");
+  printf(" -a <kernels>    [Run only these kernels, comma separated names or globs, e.g. tc_forward*,*_P]\n");
+  printf(" -l              [List the available kernels and exit]\n");
+  printf(" -H              [Count cycles, instructions, LLC, dTLB and branch misses per kernel]\n");
+  printf(" -L #            [Timed runs per kernel] (default %d)\n", LOOP_CNT);
+  printf(" -W #            [Untimed warmup runs per kernel] (default 0)\n");
+  printf(" --calibrate <filename> [Time the tc_auto candidates on samples of the graph, write a profile and exit]\n");
+  printf(" --profile <filename>   [Cost model profile for tc_auto and tc_auto_P]\n");
+  printf(" --intersect <isa>      [SIMD for the merge intersections: scalar, sse4.2, avx2, avx512, vp2intersect]\n");
+  printf("                        (default the best supported by the CPU)\n");
+  printf(" --crossovers <h,g>     [Degree ratios from which the adaptive kernels use a hash (h) and galloping (g)\n");
+  printf("                        instead of the merge, or calibrate to measure them] (default %g,%g)\n",
+	 intersectHashRatio, intersectGallopRatio);
+  printf(" --hubs <k>[,size]      [Keep bitmaps of the adjacency lists of the k highest degree vertices (degree >= %d)\n", HUB_MIN_DEGREE);
+  printf("                        for the hash kernels, in at most size bytes (K, M, G suffixes; default %zuM);\n",
+	 HUB_DEFAULT_BUDGET >> 20);
+  printf("                        with -N replicate one copy serves every replica]\n");
+  printf(" --plugin <file.so>[:symbol] [Load a kernel (default %s) from a shared object; repeat to run\n", PLUGIN_DEFAULT_SYMBOL);
+  printf("                  a tournament of the plugins in a random order every round instead of the kernels]\n");
+  printf(" -M size         [Skip kernels predicted to need more heap than size bytes, K/M/G/T suffix]\n");
   printf(" -x              [Do not run N^3 algorithms]\n");
   printf(" -B              [Benchmark BFS algorithms]\n");
   exit (8);
 }
 
+/* A size in bytes with an optional K, M, G or T suffix; false if malformed */
+static bool parse_bytes(const char *arg, size_t *bytes) {
+  char *end;
+  double size = strtod(arg, &end);
+  switch (*end) {
+  case 'T': case 't': size *= 1024.0; /* fall through */
+  case 'G': case 'g': size *= 1024.0; /* fall through */
+  case 'M': case 'm': size *= 1024.0; /* fall through */
+  case 'K': case 'k': size *= 1024.0; end++; break;
+  default: break;
+  }
+  if ((end == arg) || (*end != '\0') || (size < 1.0)) return false;
+  *bytes = (size_t)size;
+  return true;
+}
+
 static void parseFlags(int argc, char **argv) {
 
   if (argc < 1) usage();
@@ -88,6 +190,32 @@ static void parseFlags(int argc, char **argv) {
       argc-=2;
       break;
 
+    case 'O':
+      if (argc < 3) usage();
+      REPORTFILENAME = argv[2];
+      argv+=2;
+      argc-=2;
+      break;
+
+    case 'w':
+      if (argc < 3) usage();
+      CSRFILENAME = argv[2];
+      argv+=2;
+      argc-=2;
+      break;
+
+    case 'm':
+      if (argc < 3) usage();
+      for (char *opt = strtok(argv[2], ",") ; opt != NULL ; opt = strtok(NULL, ",")) {
+	if (strcmp(opt, "populate") == 0) CSR_FLAGS |= CSR_MAP_POPULATE;
+	else if (strcmp(opt, "huge") == 0) CSR_FLAGS |= CSR_MAP_HUGE;
+	else if (strcmp(opt, "noverify") == 0) CSR_FLAGS |= CSR_NO_VERIFY;
+	else usage();
+      }
+      argv+=2;
+      argc-=2;
+      break;
+
     case 'r':
       if (argc < 3) usage();
       SCALE = atoi(argv[2]);
@@ -99,6 +227,90 @@ static void parseFlags(int argc, char **argv) {
       argc-=2;
       break;
 
+    case 'g':
+      if (argc < 3) usage();
+      GEN_SPEC = argv[2];
+      INFILENAME = GEN_SPEC;
+      input_selected = true;
+      argv+=2;
+      argc-=2;
+      break;
+
+    case 'c':
+      if (argc < 3) usage();
+      {
+	char *arg = strchr(argv[2], ':');
+	if (arg != NULL) *arg++ = '\0';
+	if (strcmp(argv[2], "fast") == 0) ORACLE_MODE = ORACLE_FAST;
+	else if (strcmp(argv[2], "wedge") == 0) ORACLE_MODE = ORACLE_WEDGE;
+	else if (strcmp(argv[2], "none") == 0) ORACLE_MODE = ORACLE_NONE;
+	else if (strcmp(argv[2], "sample") == 0) {
+	  ORACLE_MODE = ORACLE_SAMPLE;
+	  if (arg != NULL) ORACLE_SAMPLES = strtoul(arg, NULL, 10);
+	  if (ORACLE_SAMPLES == 0) usage();
+	}
+	else if (strcmp(argv[2], "file") == 0) {
+	  ORACLE_MODE = ORACLE_FILE;
+	  ORACLE_FILENAME = arg;
+	}
+	else usage();
+      }
+      argv+=2;
+      argc-=2;
+      break;
+
+    case 'N':
+      if (argc < 3) usage();
+      for (char *opt = strtok(argv[2], ",") ; opt != NULL ; opt = strtok(NULL, ",")) {
+	if (strcmp(opt, "interleave") == 0) PLACEMENT = PLACE_INTERLEAVE;
+	else if (strcmp(opt, "firsttouch") == 0) PLACEMENT = PLACE_FIRST_TOUCH;
+	else if (strcmp(opt, "replicate") == 0) PLACEMENT = PLACE_REPLICATE;
+	else if (strcmp(opt, "bind") == 0) BIND_THREADS = true;
+	else usage();
+      }
+      argv+=2;
+      argc-=2;
+      break;
+
+    case 'R':
+      PROTECT = true;
+      argv++;
+      argc--;
+      break;
+
+    case 's':
+      if (argc < 3) usage();
+      RMAT_PARAMS.seed = strtoull(argv[2], NULL, 10);
+      argv+=2;
+      argc-=2;
+      break;
+
+    case 'k':
+      if (argc < 3) usage();
+      {
+	double p[4];
+	int np = sscanf(argv[2], "%lf,%lf,%lf,%lf", &p[0], &p[1], &p[2], &p[3]);
+	if (np < 3) usage();
+	if (np == 3) p[3] = 1.0 - p[0] - p[1] - p[2];
+	if ((p[0] < 0) || (p[1] < 0) || (p[2] < 0) || (p[3] < 0) || (fabs(p[0] + p[1] + p[2] + p[3] - 1.0) > 1e-6)) {
+	  fprintf(stderr,"ERROR: RMAT probabilities must be non-negative and sum to 1\n");
+	  exit(8);
+	}
+	RMAT_PARAMS.a = p[0];
+	RMAT_PARAMS.b = p[1];
+	RMAT_PARAMS.c = p[2];
+	RMAT_PARAMS.d = p[3];
+      }
+      argv+=2;
+      argc-=2;
+      break;
+
+    case 'z':
+      RMAT_PARAMS.permute = true;
+      argv++;
+      argc--;
+      break;
+
     case 'q':
       QUIET = true;
       argv++;
@@ -126,12 +338,95 @@ static void parseFlags(int argc, char **argv) {
       
     case 'p':
       if (argc < 3) usage();
-      PARALLEL_PROCS = atoi(argv[2]);
+      if (strchr(argv[2], ',') == NULL)
+	PARALLEL_PROCS = (strcmp(argv[2], "max") == 0) ? omp_get_max_threads() : atoi(argv[2]);
+      else {
+	NUM_THREAD_COUNTS = 0;
+	for (char *opt = strtok(argv[2], ",") ; opt != NULL ; opt = strtok(NULL, ",")) {
+	  const int t = (strcmp(opt, "max") == 0) ? omp_get_max_threads() : atoi(opt);
+	  if ((t < 1) || (NUM_THREAD_COUNTS == MAX_THREAD_COUNTS)) usage();
+	  THREAD_COUNTS[NUM_THREAD_COUNTS++] = t;
+	}
+      }
       argv+=2;
       argc-=2;
       break;
+
+    case 'S':
+      NUM_THREAD_COUNTS = 0;
+      for (int t = 1 ; t < omp_get_max_threads() ; t *= 2)
+	THREAD_COUNTS[NUM_THREAD_COUNTS++] = t;
+      THREAD_COUNTS[NUM_THREAD_COUNTS++] = omp_get_max_threads();
+      argv++;
+      argc--;
+      break;
 #endif
 	
+    case 'a':
+      if (argc < 3) usage();
+      KERNEL_PATTERNS = argv[2];
+      argv+=2;
+      argc-=2;
+      break;
+
+    case 'l':
+      list_kernels(stdout);
+      exit(0);
+
+    case 'H':
+      PERF_COUNTERS = true;
+      argv++;
+      argc--;
+      break;
+
+    case 'L':
+      if (argc < 3) usage();
+      LOOPS = atoi(argv[2]);
+      if (LOOPS < 1) usage();
+      argv+=2;
+      argc-=2;
+      break;
+
+    case 'W':
+      if (argc < 3) usage();
+      WARMUP = atoi(argv[2]);
+      if (WARMUP < 0) usage();
+      argv+=2;
+      argc-=2;
+      break;
+
+    case 'M':
+      if (argc < 3) usage();
+      if (!parse_bytes(argv[2], &MEM_BUDGET)) usage();
+      argv+=2;
+      argc-=2;
+      break;
+
+    case '-':
+      if (argc < 3) usage();
+      if (strcmp(argv[1], "--calibrate") == 0)
+	CALIBRATE_FILENAME = argv[2];
+      else if (strcmp(argv[1], "--profile") == 0)
+	PROFILE_FILENAME = argv[2];
+      else if (strcmp(argv[1], "--intersect") == 0)
+	INTERSECT_ISA = argv[2];
+      else if (strcmp(argv[1], "--crossovers") == 0)
+	CROSSOVERS = argv[2];
+      else if (strcmp(argv[1], "--hubs") == 0) {
+	char *end;
+	HUBS = (UINT_t)strtoul(argv[2], &end, 10);
+	if ((end == argv[2]) || (HUBS == 0)) usage();
+	if ((*end == ',') && !parse_bytes(end + 1, &HUB_BUDGET)) usage();
+	if ((*end != ',') && (*end != '\0')) usage();
+      }
+      else if (strcmp(argv[1], "--plugin") == 0)
+	plugin_load(argv[2]);
+      else
+	usage();
+      argv+=2;
+      argc-=2;
+      break;
+
     case 'x':
       NCUBED = false;
       argv++;
@@ -146,62 +441,253 @@ static void parseFlags(int argc, char **argv) {
   }
 
   if (!input_selected) usage();
+
+#ifdef PARALLEL
+  /* Sort and drop repeated thread counts, so the 1-thread run of a sweep
+     comes first */
+  for (int i = 1 ; i < NUM_THREAD_COUNTS ; i++)
+    for (int j = i ; (j > 0) && (THREAD_COUNTS[j-1] > THREAD_COUNTS[j]) ; j--) {
+      const int t = THREAD_COUNTS[j];
+      THREAD_COUNTS[j] = THREAD_COUNTS[j-1];
+      THREAD_COUNTS[j-1] = t;
+    }
+  int numCounts = 0;
+  for (int i = 0 ; i < NUM_THREAD_COUNTS ; i++)
+    if ((numCounts == 0) || (THREAD_COUNTS[numCounts-1] != THREAD_COUNTS[i]))
+      THREAD_COUNTS[numCounts++] = THREAD_COUNTS[i];
+  NUM_THREAD_COUNTS = numCounts;
+#endif
   
   return;
 }
 
-static UINT_t correctTriangleCount;
-/* Check the correctness of the triangle count.
-   Return 1 if worked, 0 if failed */
-bool check_triangleCount(const GRAPH_TYPE *graph, const UINT_t numTriangles) {
-  return (numTriangles==correctTriangleCount);
+/* Run a kernel LOOPS times, after WARMUP untimed runs, on the shared,
+   read-only input graph and record the time of each run. Only the kernel
+   call itself is timed and, with -H, counted. Returns false if any run
+   gave a wrong count. With -DPHASE_TIMERS, phases gets the time per run
+   spent in each phase of the kernel. peakBytes gets the largest heap
+   growth of a run above the heap in use before it. */
+static bool time_kernel(UINT_t (*f)(const GRAPH_TYPE*), const GRAPH_TYPE *graph, const char *name, UINT_t *numTriangles, double *times, perfCounts_t *counts, double *phases, size_t *peakBytes) {
+  bool err = false;
+
+  *peakBytes = 0;
+
+  bind_threads();
+
+  for (int loop=0 ; loop<WARMUP ; loop++)
+    *numTriangles = (*f)(graph);
+
+#ifdef PHASE_TIMERS
+  for (int p = 0 ; p < PHASE_NUM ; p++)
+    phaseTime[p] = 0.0;
+#endif
+  perf_reset();
+  for (int loop=0 ; loop<LOOPS ; loop++) {
+    const size_t heapBytes = mem_current();
+    mem_reset_peak();
+    perf_start();
+    double t = get_seconds();
+    PHASE_START();
+    *numTriangles = (*f)(graph);
+    times[loop] = get_seconds() - t;
+    perf_stop();
+    *peakBytes = max(*peakBytes, mem_peak() - heapBytes);
+    if (!check_triangleCount(*numTriangles)) err = true;
+  }
+  if (err) fprintf(stderr,"ERROR with %s\n",name);
+
+  perf_read(counts);
+  for (int e = 0 ; e < PERF_NUM_EVENTS ; e++)
+    counts->count[e] /= LOOPS;
+
+  for (int p = 0 ; p < PHASE_NUM ; p++)
+#ifdef PHASE_TIMERS
+    phases[p] = phaseTime[p] / LOOPS;
+#else
+    phases[p] = 0.0;
+#endif
+
+  return !err;
 }
 
+static void run_kernel(UINT_t (*f)(const GRAPH_TYPE*), const GRAPH_TYPE *graph, const char *name, const bool parallel, const int threads, kernelResult_t *result) {
+  double *times = (double *)malloc(LOOPS * sizeof(double));
+  assert_malloc(times);
+
+  result->kernel = name;
+  result->parallel = parallel;
+  result->threads = threads;
+  result->loops = LOOPS;
+  result->times = times;
+  result->correct = time_kernel(f, graph, name, &result->numTriangles, times, &result->perf, result->phase, &result->peakBytes);
+  compute_time_stats(times, LOOPS, &result->stats);
+  report_kernel(result);
+}
 
-static void benchmarkTC(UINT_t (*f)(const GRAPH_TYPE*), const GRAPH_TYPE *originalGraph, GRAPH_TYPE *graph, const char *name) {
-  int loop, err;
-  double 
-    total_time,
-    over_time;
-  UINT_t numTriangles;
-  
-  total_time = get_seconds();
-  for (loop=0 ; loop<LOOP_CNT ; loop++) {
-    copy_graph(originalGraph, graph);
-    numTriangles = (*f)(graph);
+/* Hardware counters per run, next to the TC line of the kernel */
+static void print_perf(const char *name, const perfCounts_t *counts) {
+  if (!perf_enabled()) return;
+
+  fprintf(outfile,"PERF\t%s\t%-30s", INFILENAME, name);
+  for (int e = 0 ; e < PERF_NUM_EVENTS ; e++) {
+    if (counts->valid[e])
+      fprintf(outfile,"\t%s=%" PRIu64, perfEventName[e], counts->count[e]);
+    else
+      fprintf(outfile,"\t%s=n/a", perfEventName[e]);
   }
-  total_time = get_seconds() - total_time;
-  err = check_triangleCount(graph,numTriangles);
-  if (!err) fprintf(stderr,"ERROR with %s\n",name);
+  if (counts->valid[PERF_CYCLES] && counts->valid[PERF_INSTRUCTIONS] && (counts->count[PERF_CYCLES] > 0))
+    fprintf(outfile,"\tIPC=%.2f", (double)counts->count[PERF_INSTRUCTIONS] / (double)counts->count[PERF_CYCLES]);
+  fprintf(outfile,"\n");
+}
+
+/* Phase breakdown per run, next to the TC line of the kernel. Kernels
+   without phase marks are skipped. */
+static void print_phases(const char *name, const double *phases) {
+#ifdef PHASE_TIMERS
+  static const char *phaseName[PHASE_NUM] = PHASE_NAMES;
+  double total = 0.0;
+
+  for (int p = 0 ; p < PHASE_NUM ; p++)
+    total += phases[p];
+  if (total <= 0.0) return;
+
+  fprintf(outfile,"PHASES\t%s\t%-30s", INFILENAME, name);
+  for (int p = 0 ; p < PHASE_NUM ; p++)
+    fprintf(outfile,"\t%s=%9.6f", phaseName[p], phases[p]);
+  fprintf(outfile,"\n");
+#else
+  (void)name; (void)phases;
+#endif
+}
+
+/* Tournament of the --plugin kernels on the same graph: each round runs
+   every plugin once, in a new random order, so that drift in clock
+   frequency or temperature spreads evenly over the plugins. WARMUP
+   rounds are untimed. */
+static void benchmarkTournament(const GRAPH_TYPE *graph) {
+  const int num = plugin_count();
+  double *times = (double *)malloc((size_t)num * LOOPS * sizeof(double));
+  assert_malloc(times);
+  kernelResult_t *results = (kernelResult_t *)calloc(num, sizeof(kernelResult_t));
+  assert_malloc(results);
+  int *order = (int *)malloc(num * sizeof(int));
+  assert_malloc(order);
+
+  for (int k = 0 ; k < num ; k++) {
+    results[k].kernel = plugin_get(k)->name;
+    results[k].threads = 1;
+    results[k].loops = LOOPS;
+    results[k].times = times + (size_t)k * LOOPS;
+    results[k].correct = true;
+  }
+
+  bind_threads();
+
+  for (int round = -WARMUP ; round < LOOPS ; round++) {
+    for (int k = 0 ; k < num ; k++)
+      order[k] = k;
+    for (int k = num - 1 ; k > 0 ; k--) {
+      const int j = (int)(random_u64(RMAT_PARAMS.seed, (uint64_t)(round + WARMUP), k) % (uint64_t)(k + 1));
+      const int tmp = order[k]; order[k] = order[j]; order[j] = tmp;
+    }
 
-  over_time = get_seconds();
-  for (loop=0 ; loop<LOOP_CNT ; loop++) {
-    copy_graph(originalGraph, graph);
+    for (int i = 0 ; i < num ; i++) {
+      kernelResult_t *r = &results[order[i]];
+      const size_t heapBytes = mem_current();
+      mem_reset_peak();
+      double t = get_seconds();
+      r->numTriangles = plugin_get(order[i])->f(graph);
+      t = get_seconds() - t;
+      if (round < 0) continue;
+      r->times[round] = t;
+      r->peakBytes = max(r->peakBytes, mem_peak() - heapBytes);
+      if (!check_triangleCount(r->numTriangles)) r->correct = false;
+    }
   }
-  over_time = get_seconds() - over_time;
 
-  total_time -= over_time;
-  total_time /= (double)LOOP_CNT;
+  double best = 0.0;
+  for (int k = 0 ; k < num ; k++) {
+    kernelResult_t *r = &results[k];
+    if (!r->correct) fprintf(stderr,"ERROR with %s\n", r->kernel);
+    compute_time_stats(r->times, LOOPS, &r->stats);
+    report_kernel(r);
+    fprintf(outfile,"TC\t%s\t%12" PRIUINT "\t%12" PRIUINT "\t%-30s\t%9.6f\t%12" PRIUINT "\t%9.1f MiB\n",
+	    INFILENAME,
+	    graph->numVertices, (graph->numEdges)/2,
+	    r->kernel, r->stats.mean, r->numTriangles,
+	    (double)r->peakBytes / MIB);
+    if (r->correct && ((best == 0.0) || (r->stats.median < best)))
+      best = r->stats.median;
+  }
 
-  fprintf(outfile,"TC\t%s\t%12d\t%12d\t%-30s\t%9.6f\t%12d\n",
+  /* Ranking by median, wrong counts last */
+  for (int k = 0 ; k < num ; k++)
+    order[k] = k;
+  for (int k = 1 ; k < num ; k++)
+    for (int j = k ; j > 0 ; j--) {
+      const kernelResult_t *a = &results[order[j-1]], *b = &results[order[j]];
+      if ((a->correct == b->correct) ? (a->stats.median <= b->stats.median) : a->correct) break;
+      const int tmp = order[j]; order[j] = order[j-1]; order[j-1] = tmp;
+    }
+  for (int i = 0 ; i < num ; i++) {
+    const kernelResult_t *r = &results[order[i]];
+    fprintf(outfile,"TOURNAMENT\t%s\t%3d\t%-30s\tmedian %9.6f\tci95 %9.6f\t",
+	    INFILENAME, i + 1, r->kernel, r->stats.median, r->stats.ci95);
+    if (r->correct)
+      fprintf(outfile,"%6.2fx the best\n", (best > 0.0) ? r->stats.median / best : 0.0);
+    else
+      fprintf(outfile,"wrong count\n");
+  }
+  fflush(outfile);
+
+  free(order);
+  free(results);
+  free(times);
+}
+
+/* With -M, a kernel runs only if its predicted heap footprint fits */
+static bool within_budget(const kernel_t *kernel, const GRAPH_TYPE *graph, const int threads) {
+  if (MEM_BUDGET == 0) return true;
+
+  const size_t bytes = kernel_footprint(kernel, graph, threads);
+  if (bytes <= MEM_BUDGET) return true;
+
+  fprintf(outfile,"SKIP\t%s\t%-30s\t%12d\tpredicted %.1f MiB exceeds the budget of %.1f MiB\n",
+	  INFILENAME, kernel->name, threads, (double)bytes / MIB, (double)MEM_BUDGET / MIB);
+  fflush(outfile);
+  return false;
+}
+
+/* Returns the median time, 0 if the kernel gave a wrong count */
+static double benchmarkTC(UINT_t (*f)(const GRAPH_TYPE*), const GRAPH_TYPE *graph, const char *name) {
+  kernelResult_t result;
+  result.oneThreadTime = 0.0;
+  result.serialTime = 0.0;
+  result.serialKernel = NULL;
+  run_kernel(f, graph, name, false, 1, &result);
+
+  fprintf(outfile,"TC\t%s\t%12" PRIUINT "\t%12" PRIUINT "\t%-30s\t%9.6f\t%12" PRIUINT "\t%9.1f MiB\n",
 	  INFILENAME,
 	  graph->numVertices, (graph->numEdges)/2,
-	  name, total_time, numTriangles);
+	  name, result.stats.mean, result.numTriangles,
+	  (double)result.peakBytes / MIB);
+  print_perf(name, &result.perf);
+  print_phases(name, result.phase);
   fflush(outfile);
 
+  free(result.times);
+  return result.correct ? result.stats.median : 0.0;
 }
 
 #ifdef PARALLEL
-static void benchmarkBFS(void (*f)(const GRAPH_TYPE*, const UINT_t, UINT_t*, bool*), const GRAPH_TYPE *originalGraph, const char *name) {
-  int loop, err;
-  double 
-    total_time,
-    over_time;
+static void benchmarkBFS(void (*f)(const GRAPH_TYPE*, const UINT_t, UINT_t*, bool*), const GRAPH_TYPE *graph, const char *name) {
+  int loop;
+  double total_time;
   bool *visited;
   UINT_t *level;
   UINT_t i, n;
 
-  n = originalGraph->numVertices;
+  n = graph->numVertices;
 
   visited = (bool *)malloc(n * sizeof(bool));
   assert_malloc(visited);
@@ -209,32 +695,32 @@ static void benchmarkBFS(void (*f)(const GRAPH_TYPE*, const UINT_t, UINT_t*, boo
   assert_malloc(level);
   
   total_time = get_seconds();
-  for (loop=0 ; loop<LOOP_CNT ; loop++) {
+  for (loop=0 ; loop<LOOPS ; loop++) {
     for(i=0; i<n ; i++) {
       visited[i] = false;
       level[i]   = n+1;
     }
     for(i=0; i<n ; i++) {
       if (!visited[i])
-	(*f)(originalGraph, i, level, visited);
+	(*f)(graph, i, level, visited);
     }
   }
   total_time = get_seconds() - total_time;
 
-  total_time /= (double)LOOP_CNT;
+  total_time /= (double)LOOPS;
 
   if (name[strlen(name)-1] != 'P') {
-    fprintf(outfile,"BFS\t%s\t%12d\t%12d\t%-30s\t%9.6f\n",
+    fprintf(outfile,"BFS\t%s\t%12" PRIUINT "\t%12" PRIUINT "\t%-30s\t%9.6f\n",
 	    INFILENAME,
-	    originalGraph->numVertices, (originalGraph->numEdges)/2,
+	    graph->numVertices, (graph->numEdges)/2,
 	    name, total_time);
   }
   else {
 #pragma omp parallel
 #pragma omp master
-    fprintf(outfile,"BFS\t%s\t%12d\t%12d\t%-30s\t%9.6f\t%12d\n",
+    fprintf(outfile,"BFS\t%s\t%12" PRIUINT "\t%12" PRIUINT "\t%-30s\t%9.6f\t%12d\n",
 	    INFILENAME,
-	    originalGraph->numVertices, (originalGraph->numEdges)/2,
+	    graph->numVertices, (graph->numEdges)/2,
 	    name, total_time,
 	    omp_get_num_threads());
   }
@@ -245,175 +731,82 @@ static void benchmarkBFS(void (*f)(const GRAPH_TYPE*, const UINT_t, UINT_t*, boo
 }
 
 
-static void benchmarkTC_P(UINT_t (*f)(const GRAPH_TYPE*), const GRAPH_TYPE *originalGraph, GRAPH_TYPE *graph, const char *name) {
-  int loop, err;
-  double 
-    total_time,
-    over_time;
-  UINT_t numTriangles;
-  
-  total_time = get_seconds();
-  for (loop=0 ; loop<LOOP_CNT ; loop++) {
-    copy_graph(originalGraph, graph);
-    numTriangles = (*f)(graph);
-  }
-  total_time = get_seconds() - total_time;
-  err = check_triangleCount(graph,numTriangles);
-  if (!err) fprintf(stderr,"ERROR with %s\n",name);
-
-  over_time = get_seconds();
-  for (loop=0 ; loop<LOOP_CNT ; loop++) {
-    copy_graph(originalGraph, graph);
-  }
-  over_time = get_seconds() - over_time;
-
-  total_time -= over_time;
-  total_time /= (double)LOOP_CNT;
+/* Returns the median time, 0 if the kernel gave a wrong count. In a
+   thread sweep the speedup and parallel efficiency are reported against
+   the kernel's 1-thread run (oneThreadTime, 0 if none) and against the
+   fastest serial kernel of this run. */
+static double benchmarkTC_P(UINT_t (*f)(const GRAPH_TYPE*), const GRAPH_TYPE *graph, const char *name, const double oneThreadTime) {
+  kernelResult_t result;
+  int threads = 1;
 
 #pragma omp parallel
 #pragma omp master
-  fprintf(outfile,"TC_P\t%s\t%12d\t%12d\t%-30s\t%9.6f\t%12d\t%12d\n",
+  threads = omp_get_num_threads();
+
+  result.oneThreadTime = oneThreadTime;
+  result.serialTime = bestSerialTime;
+  result.serialKernel = bestSerialName;
+  run_kernel(f, graph, name, true, threads, &result);
+
+  fprintf(outfile,"TC_P\t%s\t%12" PRIUINT "\t%12" PRIUINT "\t%-30s\t%9.6f\t%12" PRIUINT "\t%12d\t%9.1f MiB\n",
 	  INFILENAME,
 	  graph->numVertices, (graph->numEdges)/2,
-	  name, total_time, numTriangles,
-	  omp_get_num_threads());
+	  name, result.stats.mean, result.numTriangles,
+	  threads, (double)result.peakBytes / MIB);
+  print_perf(name, &result.perf);
+  print_phases(name, result.phase);
+  if (NUM_THREAD_COUNTS > 0) {
+    fprintf(outfile,"SCALING\t%s\t%-30s\t%12d\t%9.6f", INFILENAME, name, threads, result.stats.median);
+    if (result.oneThreadTime > 0.0)
+      fprintf(outfile,"\tspeedup=%.2f\tefficiency=%.2f",
+	      result.oneThreadTime / result.stats.median, result.oneThreadTime / result.stats.median / threads);
+    else
+      fprintf(outfile,"\tspeedup=n/a\tefficiency=n/a");
+    if (result.serialTime > 0.0)
+      fprintf(outfile,"\tspeedup_serial=%.2f\tefficiency_serial=%.2f\t(%s)",
+	      result.serialTime / result.stats.median, result.serialTime / result.stats.median / threads, result.serialKernel);
+    else
+      fprintf(outfile,"\tspeedup_serial=n/a\tefficiency_serial=n/a");
+    fprintf(outfile,"\n");
+  }
   fflush(outfile);
 
+  free(result.times);
+  return result.correct ? result.stats.median : 0.0;
 }
 #endif
 
-static int compareEdge_t(const void *a, const void *b) {
-    edge_t arg1 = *(const edge_t *)a;
-    edge_t arg2 = *(const edge_t *)b;
-    if (arg1.src < arg2.src) return -1;
-    if (arg1.src > arg2.src) return 1;
-    if ((arg1.src == arg2.src) && (arg1.dst < arg2.dst)) return -1;
-    if ((arg1.src == arg2.src) && (arg1.dst > arg2.dst)) return 1;
-    return 0;
-}
-
-
-static void readMatrixMarketFile(const char *filename, GRAPH_TYPE* graph) {
-  FILE *infile = fopen(filename, "r");
-  if (infile == NULL) {
-    printf("Error opening file %s.\n", filename);
-    exit(1);
-  }
-
-  char line[256];
-  UINT_t num_rows, num_cols, num_entries;
-
-  // Skip the header lines
-  do {
-    fgets(line, sizeof(line), infile);
-  } while (line[0] == '%');
-
-  sscanf(line, "%d %d %d", &num_rows, &num_cols, &num_entries);
-
-  if (num_rows != num_cols) {
-    fprintf(stderr,"ERROR: Matrix Market input file is not square: rows: %d  cols: %d  nnz: %d\n",
-	    num_rows, num_cols, num_entries);
-    exit(-1);
-  }
-
-#if DEBUG
-  printf("readMatrixMarketFile: %d %d %d\n",num_rows, num_cols, num_entries);
-#endif
-
-  UINT_t edgeCount = 0;
-  edge_t* edges = (edge_t*)calloc(2*num_entries, sizeof(edge_t));
-  assert_malloc(edges);
-
-  for (UINT_t i = 0; i < num_entries; i++) {
-    UINT_t row, col;
-    if (fscanf(infile, "%d %d\n", &row, &col) != 2) {
-      fprintf(stderr,"Invalid Matrix Market file: bad entry.\n");
-      fclose(infile);
-      fclose(outfile);
-      exit(8);
-    }
-    if ((row > num_rows) || (col > num_rows)) {
-      fprintf(stderr,"Invalid Matrix Market file: entry out of range.\n");
-      fclose(infile);
-      fclose(outfile);
-      exit(8);
-    }
-
-    edges[edgeCount].src = row - 1;
-    edges[edgeCount].dst = col - 1;
-    edgeCount++;
-    edges[edgeCount].src = col - 1;
-    edges[edgeCount].dst = row - 1;
-    edgeCount++;
-  }
-
-  qsort(edges, edgeCount, sizeof(edge_t), compareEdge_t);
-
-  edge_t* edgesNoDup = (edge_t*)calloc(2*num_entries, sizeof(edge_t));
-  assert_malloc(edgesNoDup);
-
-  UINT_t edgeCountNoDup;
-  edge_t lastedge;
-  lastedge.src = edges[0].src;
-  lastedge.dst = edges[0].dst;
-  edgesNoDup[0].src = edges[0].src;
-  edgesNoDup[0].dst = edges[0].dst;
-  edgeCountNoDup = 1;
-  for (UINT_t i=0 ; i<edgeCount ; i++) {
-    if (compareEdge_t(&lastedge,&edges[i])!=0) {
-      edgesNoDup[edgeCountNoDup].src = edges[i].src;
-      edgesNoDup[edgeCountNoDup].dst = edges[i].dst;
-      edgeCountNoDup++;
-      lastedge.src = edges[i].src;
-      lastedge.dst = edges[i].dst;
-    }
-  }
-    
-    
-  graph->numVertices = num_rows;
-  graph->numEdges = edgeCountNoDup;
-  allocate_graph(graph);
-
-  convert_edges_to_graph(edgesNoDup, graph);
-
-  free(edgesNoDup);
-  free(edges);
-
-  fclose(infile);
-  return;
-}
-
-
-
 int
 main(int argc, char **argv) {
-  UINT_t numTriangles = 0;
+  bool mapped = false;
 
   outfile = stdout;
 
   parseFlags(argc, argv);
+  if (PROFILE_FILENAME != NULL)
+    auto_load_profile(PROFILE_FILENAME);
+  intersect_init(INTERSECT_ISA);
   
-  GRAPH_TYPE 
-    *originalGraph,
-    *graph;
+  GRAPH_TYPE *graph;
 
-  originalGraph = (GRAPH_TYPE *)malloc(sizeof(GRAPH_TYPE));
-  assert_malloc(originalGraph);
   graph = (GRAPH_TYPE *)malloc(sizeof(GRAPH_TYPE));
   assert_malloc(graph);
 
 
   if (SCALE) {
-    allocate_graph_RMAT(SCALE, EDGE_FACTOR, originalGraph);
-    create_graph_RMAT(originalGraph, SCALE);
-    allocate_graph_RMAT(SCALE, EDGE_FACTOR, graph);
+    create_graph_RMAT(graph, SCALE, EDGE_FACTOR, &RMAT_PARAMS);
+  }
+  else if (GEN_SPEC != NULL) {
+    create_graph_generator(graph, GEN_SPEC, RMAT_PARAMS.seed);
   }
   else {
     if (INFILENAME != NULL) {
-      readMatrixMarketFile(INFILENAME, originalGraph);
-      graph->numVertices = originalGraph->numVertices;
-      graph->numEdges = originalGraph->numEdges;
-      allocate_graph(graph);
+      if (isCSRFile(INFILENAME)) {
+	readCSRFile(INFILENAME, graph, CSR_FLAGS);
+	mapped = true;
+      }
+      else
+	readMatrixMarketFile(INFILENAME, graph);
     }
     else {
       fprintf(stderr,"ERROR: No input graph selected.\n");
@@ -421,108 +814,185 @@ main(int argc, char **argv) {
     }
   }
 
-  if (!QUIET)
-    fprintf(outfile,"Graph has %d vertices and %d undirected edges. Timing loop count %d.\n", originalGraph->numVertices, originalGraph->numEdges/2, LOOP_CNT);
+  if (CROSSOVERS != NULL)
+    intersect_crossovers(CROSSOVERS, graph, QUIET ? NULL : outfile);
+
+  if (!QUIET) {
+    fprintf(outfile,"Graph has %" PRIUINT " vertices and %" PRIUINT " undirected edges. Timing loop count %d.\n", graph->numVertices, graph->numEdges/2, LOOPS);
+    const double graphBytes = (double)(graph->numVertices + 1) * sizeof(UINT_t) + (double)graph->numEdges * sizeof(VERTEX_t);
+    const double narrowBytes = (double)(graph->numVertices + 1) * sizeof(uint32_t) + (double)graph->numEdges * sizeof(uint32_t);
+    fprintf(outfile,"Graph memory: %.1f MB (%d-bit row pointers and counts, %d-bit column indices), %+.1f MB over a 32-bit build.\n",
+	    graphBytes / 1.0e6, (int)(8 * sizeof(UINT_t)), (int)(8 * sizeof(VERTEX_t)), (graphBytes - narrowBytes) / 1.0e6);
+    fprintf(outfile,"Merge intersections: %s%s\n", intersect_isa_name(),
+	    (sizeof(VERTEX_t) == sizeof(uint32_t)) ? "" : " (scalar for the 64-bit column indices of this build)");
+    fprintf(outfile,"Adaptive intersections: hash from degree ratio %g, galloping from %g\n",
+	    intersectHashRatio, intersectGallopRatio);
+  }
 
   if (PRINT)
-    print_graph(originalGraph, outfile);
+    print_graph(graph, outfile);
+
+  if (CSRFILENAME != NULL)
+    writeCSRFile(CSRFILENAME, graph);
 
   if (!QUIET)
-    fprintf(outfile,"%% of horizontal edges from bfs (k): %9.6f\n",tc_bader_compute_k(originalGraph));
+    fprintf(outfile,"%% of horizontal edges from bfs (k): %9.6f\n",tc_bader_compute_k(graph));
 
-  copy_graph(originalGraph, graph);
-  numTriangles = tc_wedge(graph);
-  correctTriangleCount = numTriangles;
+  /* Every kernel shares the one input graph */
+  if ((PLACEMENT != PLACE_NONE) || BIND_THREADS)
+    placement_init(BIND_THREADS);
+  if (PLACEMENT != PLACE_NONE) {
+    int numThreads = 1;
+#ifdef PARALLEL
+    numThreads = PARALLEL_MAX ? omp_get_max_threads() :
+      (NUM_THREAD_COUNTS > 0) ? THREAD_COUNTS[NUM_THREAD_COUNTS-1] :
+      (PARALLEL_PROCS > 0) ? PARALLEL_PROCS : omp_get_max_threads();
+#endif
+    GRAPH_TYPE *graph2 = place_graph(graph, PLACEMENT, numThreads, PROTECT);
+    if (mapped)
+      unmapCSRFile(graph);
+    else
+      free_graph(graph);
+    graph = graph2;
+  }
+  else if (PROTECT) {
+    GRAPH_TYPE *graph2 = protect_graph(graph);
+    if (mapped)
+      unmapCSRFile(graph);
+    else
+      free_graph(graph);
+    graph = graph2;
+  }
+
+  if (HUBS > 0) {
+    const double t = get_seconds();
+    hub_build(graph, HUBS, HUB_BUDGET);
+    if (!QUIET)
+      fprintf(outfile,"Hub bitmaps: %" PRIUINT " hubs of degree >= %" PRIUINT ", %.1f MB, built in %9.6f s\n",
+	      hubBitmaps.numHubs, hubBitmaps.minDegree, (double)hubBitmaps.bytes / 1.0e6, get_seconds() - t);
+  }
+
+  if ((ORACLE_MODE == ORACLE_FILE) && (ORACLE_FILENAME == NULL)) {
+    if (SCALE || (GEN_SPEC != NULL)) {
+      fprintf(stderr,"ERROR: -c file needs a file name for generated graphs\n");
+      exit(8);
+    }
+    ORACLE_FILENAME = (char *)malloc(strlen(INFILENAME) + 4);
+    assert_malloc(ORACLE_FILENAME);
+    sprintf(ORACLE_FILENAME, "%s.tc", INFILENAME);
+  }
+  oracle_init(graph, ORACLE_MODE, ORACLE_FILENAME, ORACLE_SAMPLES, RMAT_PARAMS.seed);
+
+  if (CALIBRATE_FILENAME != NULL) {
+#ifdef PARALLEL
+    if (PARALLEL_MAX || (PARALLEL_PROCS > 0))
+      omp_set_num_threads(PARALLEL_MAX ? omp_get_max_threads() : PARALLEL_PROCS);
+#endif
+    auto_calibrate(graph, CALIBRATE_FILENAME, RMAT_PARAMS.seed, outfile);
+    goto done;
+  }
+
+  if (PERF_COUNTERS)
+    perf_init();
+
+  if (REPORTFILENAME != NULL) {
+    report_open(REPORTFILENAME);
+    report_graph(graph, INFILENAME);
+  }
+
+  if (plugin_count() > 0) {
+    benchmarkTournament(graph);
+    goto done;
+  }
 
 #ifdef PARALLEL
   if (BENCHMARK_BFS) {
-    benchmarkBFS(bfs_visited, originalGraph, "bfs_visited");
-    benchmarkBFS(bfs_visited_P, originalGraph, "bfs_visited_P");
-    benchmarkBFS(bfs_hybrid_visited, originalGraph, "bfs_hybrid_visited");
-    benchmarkBFS(bfs_hybrid_visited_P, originalGraph, "bfs_hybrid_visited_P");
-    benchmarkBFS(bfs_chatgpt_P, originalGraph, "bfs_chatgpt_P");
-    benchmarkBFS(bfs_locks_P, originalGraph, "bfs_locks_P");
-    //    benchmarkBFS(bfs_beamerGAP_P, originalGraph, "bfs_beamerGAP_P");
+    benchmarkBFS(bfs_visited, graph, "bfs_visited");
+    benchmarkBFS(bfs_visited_P, graph, "bfs_visited_P");
+    benchmarkBFS(bfs_hybrid_visited, graph, "bfs_hybrid_visited");
+    benchmarkBFS(bfs_hybrid_visited_P, graph, "bfs_hybrid_visited_P");
+    benchmarkBFS(bfs_chatgpt_P, graph, "bfs_chatgpt_P");
+    benchmarkBFS(bfs_locks_P, graph, "bfs_locks_P");
+    //    benchmarkBFS(bfs_beamerGAP_P, graph, "bfs_beamerGAP_P");
     goto done;
   }
 #endif
 
-  benchmarkTC(tc_wedge, originalGraph, graph, "tc_wedge");
-  benchmarkTC(tc_wedge_DO, originalGraph, graph, "tc_wedge_DO");
-  benchmarkTC(tc_intersectMergePath, originalGraph, graph, "tc_intersect_MergePath");
-  benchmarkTC(tc_intersectMergePath_DO, originalGraph, graph, "tc_intersect_MergePath_DO");
-  benchmarkTC(tc_intersectBinarySearch, originalGraph, graph, "tc_intersect_BinarySearch");
-  benchmarkTC(tc_intersectBinarySearch_DO, originalGraph, graph, "tc_intersect_BinarySearch_DO");
-  benchmarkTC(tc_intersectPartition, originalGraph, graph, "tc_intersect_Partition");
-  benchmarkTC(tc_intersectPartition_DO, originalGraph, graph, "tc_intersect_Partition_DO");
-  benchmarkTC(tc_intersectHash, originalGraph, graph, "tc_intersect_Hash");
-  benchmarkTC(tc_intersectHash_DO, originalGraph, graph, "tc_intersect_Hash_DO");
-  benchmarkTC(tc_forward, originalGraph, graph, "tc_forward");
-  benchmarkTC(tc_forward_hash, originalGraph, graph, "tc_forward_hash");
-  benchmarkTC(tc_forward_hash_skip, originalGraph, graph, "tc_forward_hash_skip");
-  benchmarkTC(tc_forward_hash_degreeOrder, originalGraph, graph, "tc_forward_hash_degreeOrder");
-  benchmarkTC(tc_forward_hash_degreeOrderReverse, originalGraph, graph, "tc_forward_hash_degreeOrderRev");
-  benchmarkTC(tc_compact_forward, originalGraph, graph, "tc_compact_forward");
-  benchmarkTC(tc_fast_llm, originalGraph, graph, "tc_fast_llm");
-  benchmarkTC(tc_davis, originalGraph, graph, "tc_davis");
-  benchmarkTC(tc_low, originalGraph, graph, "tc_low");
-  benchmarkTC(tc_bader, originalGraph, graph, "tc_bader");
-  benchmarkTC(tc_bader2, originalGraph, graph, "tc_bader2");
-  benchmarkTC(tc_bader3, originalGraph, graph, "tc_bader3");
-  benchmarkTC(tc_bader4, originalGraph, graph, "tc_bader4");
-  benchmarkTC(tc_bader5, originalGraph, graph, "tc_bader5");
-  benchmarkTC(tc_bader4_degreeOrder, originalGraph, graph, "tc_bader4_degreeOrder");
-  benchmarkTC(tc_bader_forward_hash, originalGraph, graph, "tc_bader_forward_hash");
-  benchmarkTC(tc_bader_forward_hash_degreeOrder, originalGraph, graph, "tc_bader_forward_hash_degOrd");
-  benchmarkTC(tc_bader_recursive, originalGraph, graph, "tc_bader_recursive");
-  benchmarkTC(tc_bader_hybrid, originalGraph, graph, "tc_bader_hybrid");
-  benchmarkTC(tc_bader_new_bfs, originalGraph, graph, "tc_bader_new_bfs");
-  benchmarkTC(tc_treelist, originalGraph, graph, "tc_treelist");
-  benchmarkTC(tc_treelist2, originalGraph, graph, "tc_treelist2");
-  if (NCUBED)
-    benchmarkTC(tc_triples, originalGraph, graph, "tc_triples");
-  if (NCUBED)
-    benchmarkTC(tc_triples_DO, originalGraph, graph, "tc_triples_DO");
-  
+  if (!QUIET)
+    for (int k = 0 ; k < numKernels ; k++)
+      if (((kernels[k].f == tc_auto)
 #ifdef PARALLEL
+	   || (kernels[k].f == tc_auto_P)
+#endif
+	   ) && kernel_selected(&kernels[k], KERNEL_PATTERNS)) {
+	auto_print(graph, outfile);
+	break;
+      }
 
-  omp_set_num_threads(PARALLEL_MAX ? omp_get_max_threads() : PARALLEL_PROCS);
+#ifdef PARALLEL
+  bool threadsSet = false;
+#endif
+  for (int k = 0 ; k < numKernels ; k++) {
+    const kernel_t *kernel = &kernels[k];
+    if (!kernel_selected(kernel, KERNEL_PATTERNS))
+      continue;
+#ifdef PARALLEL
+    if (kernel->parallel) {
+      if (NUM_THREAD_COUNTS > 0) {
+	if (!threadsSet && !QUIET) {
+	  fprintf(outfile,"OpenMP thread sweep:");
+	  for (int i = 0 ; i < NUM_THREAD_COUNTS ; i++)
+	    fprintf(outfile," %d", THREAD_COUNTS[i]);
+	  fprintf(outfile,"\n");
+	}
+	threadsSet = true;
+	double oneThreadTime = 0.0;
+	for (int i = 0 ; i < NUM_THREAD_COUNTS ; i++) {
+	  omp_set_num_threads(THREAD_COUNTS[i]);
+	  if (!within_budget(kernel, graph, THREAD_COUNTS[i])) continue;
+	  const double t = benchmarkTC_P(kernel->f, graph, kernel->name, oneThreadTime);
+	  if (THREAD_COUNTS[i] == 1) oneThreadTime = t;
+	}
+	continue;
+      }
+      if (!threadsSet) {
+	omp_set_num_threads(PARALLEL_MAX ? omp_get_max_threads() : PARALLEL_PROCS);
 #pragma omp parallel
-  if (!QUIET) {
+	if (!QUIET) {
 #pragma omp master
-    fprintf(outfile,"OpenMP threads: %12d\n",omp_get_num_threads());
-  }
-
-  
-  benchmarkTC_P(tc_wedge_P, originalGraph, graph, "tc_wedge_P");
-  benchmarkTC_P(tc_wedge_DO_P, originalGraph, graph, "tc_wedge_DO_P");
-  benchmarkTC_P(tc_intersectMergePath_P, originalGraph, graph, "tc_intersect_MergePath_P");
-  benchmarkTC_P(tc_intersectMergePath_DO_P, originalGraph, graph, "tc_intersect_MergePath_DO_P");
-  benchmarkTC_P(tc_intersectBinarySearch_P, originalGraph, graph, "tc_intersect_BinarySearch_P");
-  benchmarkTC_P(tc_intersectBinarySearch_DO_P, originalGraph, graph, "tc_intersect_BinarySearch_DO_P");
-  benchmarkTC_P(tc_intersectPartition_P, originalGraph, graph, "tc_intersect_Partition_P");
-  benchmarkTC_P(tc_intersectPartition_DO_P, originalGraph, graph, "tc_intersect_Partition_DO_P");
-  benchmarkTC_P(tc_intersectHash_P, originalGraph, graph, "tc_intersect_Hash_P");
-  benchmarkTC_P(tc_intersectHash_DO_P, originalGraph, graph, "tc_intersect_Hash_DO_P");
-  benchmarkTC_P(tc_bader_bfs1_P, originalGraph, graph, "tc_bader_bfs1_P");
-  benchmarkTC_P(tc_bader_bfs3_P, originalGraph, graph, "tc_bader_bfs3_P");
-  benchmarkTC_P(tc_bader_bfs_visited_P, originalGraph, graph, "tc_bader_bfs_visited_P");
-  benchmarkTC_P(tc_bader_bfs_hybrid_P, originalGraph, graph, "tc_bader_bfs_hybrid_P");
-  benchmarkTC_P(tc_bader_bfs_hybrid2_P, originalGraph, graph, "tc_bader_bfs_hybrid2_P");
-  benchmarkTC_P(tc_bader_bfs_chatgpt_P, originalGraph, graph, "tc_bader_bfs_chatgpt_P");
-  benchmarkTC_P(tc_bader_bfs_locks_P, originalGraph, graph, "tc_bader_bfs_locks_P");
-  benchmarkTC_P(tc_MapJIK_P, originalGraph, graph, "tc_MapJIK_P");
-  benchmarkTC_P(tc_forward_hash_P, originalGraph, graph, "tc_forward_hash_P");
-  if (NCUBED)
-    benchmarkTC_P(tc_triples_P, originalGraph, graph, "tc_triples_P");
-  if (NCUBED)
-    benchmarkTC_P(tc_triples_DO_P, originalGraph, graph, "tc_triples_DO_P");
+	  fprintf(outfile,"OpenMP threads: %12d\n",omp_get_num_threads());
+	}
+	threadsSet = true;
+      }
+      if (within_budget(kernel, graph, omp_get_max_threads()))
+	benchmarkTC_P(kernel->f, graph, kernel->name, 0.0);
+      continue;
+    }
 #endif
+    if (!within_budget(kernel, graph, 1))
+      continue;
+    const double t = benchmarkTC(kernel->f, graph, kernel->name);
+    if ((t > 0.0) && ((bestSerialName == NULL) || (t < bestSerialTime))) {
+      bestSerialTime = t;
+      bestSerialName = kernel->name;
+    }
+  }
 
  done:
+
+  report_close();
+  perf_close();
+  plugin_unload_all();
+  hub_free();
   
-  free_graph(originalGraph);
-  free_graph(graph);
+  if (PLACEMENT != PLACE_NONE)
+    free_placed_graph(graph);
+  else if (PROTECT)
+    free_protected_graph(graph);
+  else if (mapped)
+    unmapCSRFile(graph);
+  else
+    free_graph(graph);
 
 #if 0
   if (!QUIET)
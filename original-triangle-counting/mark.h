@@ -0,0 +1,153 @@
+#ifndef _MARK_H
+#define _MARK_H
+
+/* Marker arrays of the hash kernels: the neighbors of a vertex are set,
+   other lists are tested against them, and the marks are dropped before
+   the next vertex. The kind of marker is a compile-time choice of each
+   family of kernels (MARK_INTERSECT and so on below, e.g.
+   -DMARK_DAVIS=bitset), and every kind has the same operations:
+
+     MARK_T(kind)               the marker type
+     MARK(kind, alloc)(m, n)    marks for the vertices 0..n-1, all clear
+     MARK(kind, free)(m)
+     MARK(kind, next)(m)        start a new set; all marks are clear after
+                                it, provided the old ones were unset
+     MARK(kind, set)(m, x)
+     MARK(kind, test)(m, x)
+     MARK(kind, unset)(m, x)    clear x, needed only by byte and bitset
+     MARK_BYTES(kind)           bytes per vertex, for the footprint models
+
+   The kinds:
+     byte      one bool per vertex, set and cleared again
+     bitset    one bit per vertex, an eighth of the cache footprint
+     epochN    a uintN_t stamp per vertex: x is marked when its stamp is
+               the current epoch, so next() clears every mark at once and
+               unset() is a no-op (the compiler drops the clearing loop).
+               The stamps are zeroed only when the epoch wraps around,
+               every 2^N - 1 sets.
+
+   The parallel kernels keep one marker per thread, allocated by the
+   thread in its parallel region. */
+
+#define MARK_CAT3_(a, b, c)  a##b##c
+#define MARK_CAT3(a, b, c)   MARK_CAT3_(a, b, c)
+
+#define MARK_T(kind)         MARK_CAT3(mark_, kind, _t)
+#define MARK(kind, op)       MARK_CAT3(mark_, kind, _##op)
+#define MARK_BYTES(kind)     MARK_CAT3(MARK_, kind, _BYTES)
+
+/* The marker of each family, unless set on the command line. The
+   defaults were the fastest on a Chung-Lu graph of 2^20 vertices and
+   average degree 8. tc_davis tests every wedge against the marks and
+   sets only a few, so it keeps the smallest byte test. */
+#ifndef MARK_INTERSECT          /* intersectSizeHash and friends, and their kernels */
+#define MARK_INTERSECT  epoch16
+#endif
+#ifndef MARK_DAVIS              /* tc_davis */
+#define MARK_DAVIS      byte
+#endif
+#ifndef MARK_BADER              /* the hash kernels of the tc_bader family, serial and parallel */
+#define MARK_BADER      epoch16
+#endif
+#ifndef MARK_FORWARD            /* tc_forward_hash_P, one per thread */
+#define MARK_FORWARD    bitset
+#endif
+
+
+#define MARK_byte_BYTES    1
+typedef struct {
+  bool *a;
+} mark_byte_t;
+
+static INLINE void mark_byte_alloc(mark_byte_t *m, const UINT_t n) {
+  m->a = (bool *)calloc(max(n, 1), sizeof(bool));
+  assert_malloc(m->a);
+}
+
+static INLINE void mark_byte_free(mark_byte_t *m) {
+  free(m->a);
+  m->a = NULL;
+}
+
+static INLINE void mark_byte_next(mark_byte_t *m) { (void)m; }
+static INLINE void mark_byte_set(mark_byte_t *m, const UINT_t x) { m->a[x] = true; }
+static INLINE bool mark_byte_test(const mark_byte_t *m, const UINT_t x) { return m->a[x]; }
+static INLINE void mark_byte_unset(mark_byte_t *m, const UINT_t x) { m->a[x] = false; }
+
+
+#define MARK_bitset_BYTES  0.125
+typedef struct {
+  uint64_t *a;
+} mark_bitset_t;
+
+static INLINE void mark_bitset_alloc(mark_bitset_t *m, const UINT_t n) {
+  m->a = (uint64_t *)calloc(max((n + 63) / 64, 1), sizeof(uint64_t));
+  assert_malloc(m->a);
+}
+
+static INLINE void mark_bitset_free(mark_bitset_t *m) {
+  free(m->a);
+  m->a = NULL;
+}
+
+static INLINE void mark_bitset_next(mark_bitset_t *m) { (void)m; }
+
+static INLINE void mark_bitset_set(mark_bitset_t *m, const UINT_t x) {
+  m->a[x / 64] |= (uint64_t)1 << (x % 64);
+}
+
+static INLINE bool mark_bitset_test(const mark_bitset_t *m, const UINT_t x) {
+  return (m->a[x / 64] >> (x % 64)) & 1;
+}
+
+static INLINE void mark_bitset_unset(mark_bitset_t *m, const UINT_t x) {
+  m->a[x / 64] &= ~((uint64_t)1 << (x % 64));
+}
+
+
+#define MARK_EPOCH(bits)						\
+  typedef struct {							\
+    uint##bits##_t *a;							\
+    UINT_t n;								\
+    uint##bits##_t epoch;						\
+  } mark_epoch##bits##_t;						\
+									\
+  static INLINE void mark_epoch##bits##_alloc(mark_epoch##bits##_t *m, const UINT_t n) { \
+    m->a = (uint##bits##_t *)calloc(max(n, 1), sizeof(uint##bits##_t)); \
+    assert_malloc(m->a);						\
+    m->n = n;								\
+    m->epoch = 0;							\
+  }									\
+									\
+  static INLINE void mark_epoch##bits##_free(mark_epoch##bits##_t *m) {	\
+    free(m->a);								\
+    m->a = NULL;							\
+  }									\
+									\
+  static INLINE void mark_epoch##bits##_next(mark_epoch##bits##_t *m) {	\
+    if (++m->epoch == 0) {						\
+      memset(m->a, 0, (size_t)m->n * sizeof(uint##bits##_t));		\
+      m->epoch = 1;							\
+    }									\
+  }									\
+									\
+  static INLINE void mark_epoch##bits##_set(mark_epoch##bits##_t *m, const UINT_t x) { \
+    m->a[x] = m->epoch;							\
+  }									\
+									\
+  static INLINE bool mark_epoch##bits##_test(const mark_epoch##bits##_t *m, const UINT_t x) { \
+    return m->a[x] == m->epoch;						\
+  }									\
+									\
+  static INLINE void mark_epoch##bits##_unset(mark_epoch##bits##_t *m, const UINT_t x) { \
+    (void)m; (void)x;							\
+  }
+
+#define MARK_epoch8_BYTES   1
+#define MARK_epoch16_BYTES  2
+#define MARK_epoch32_BYTES  4
+MARK_EPOCH(8)
+MARK_EPOCH(16)
+MARK_EPOCH(32)
+
+#endif
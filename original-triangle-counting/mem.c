@@ -0,0 +1,56 @@
+#define MEM_NO_REDIRECT
+#include "types.h"
+#include <malloc.h>
+
+/* The size of a block is taken from the allocator (malloc_usable_size),
+   so blocks need no header and keep the alignment of malloc. */
+static size_t memCurrent = 0;
+static size_t memPeak = 0;
+
+static void mem_add(const size_t bytes) {
+  const size_t now = __atomic_add_fetch(&memCurrent, bytes, __ATOMIC_RELAXED);
+  size_t peak = __atomic_load_n(&memPeak, __ATOMIC_RELAXED);
+  while ((now > peak) &&
+	 !__atomic_compare_exchange_n(&memPeak, &peak, now, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    ;
+}
+
+void *mem_malloc(size_t size) {
+  void *ptr = malloc(size);
+  if (ptr != NULL) mem_add(malloc_usable_size(ptr));
+  return ptr;
+}
+
+void *mem_calloc(size_t count, size_t size) {
+  void *ptr = calloc(count, size);
+  if (ptr != NULL) mem_add(malloc_usable_size(ptr));
+  return ptr;
+}
+
+void *mem_realloc(void *ptr, size_t size) {
+  const size_t old = (ptr != NULL) ? malloc_usable_size(ptr) : 0;
+  void *newPtr = realloc(ptr, size);
+  if (newPtr != NULL) {
+    __atomic_sub_fetch(&memCurrent, old, __ATOMIC_RELAXED);
+    mem_add(malloc_usable_size(newPtr));
+  }
+  return newPtr;
+}
+
+void mem_free(void *ptr) {
+  if (ptr == NULL) return;
+  __atomic_sub_fetch(&memCurrent, malloc_usable_size(ptr), __ATOMIC_RELAXED);
+  free(ptr);
+}
+
+size_t mem_current(void) {
+  return __atomic_load_n(&memCurrent, __ATOMIC_RELAXED);
+}
+
+size_t mem_peak(void) {
+  return __atomic_load_n(&memPeak, __ATOMIC_RELAXED);
+}
+
+void mem_reset_peak(void) {
+  __atomic_store_n(&memPeak, mem_current(), __ATOMIC_RELAXED);
+}
@@ -0,0 +1,25 @@
+#ifndef _MEM_H
+#define _MEM_H
+
+/* Heap accounting. types.h routes malloc, calloc, realloc and free of
+   the whole tree through these wrappers, which keep the number of live
+   heap bytes and its high-water mark since the last mem_reset_peak().
+   Safe to call from parallel regions. Define MEM_NO_REDIRECT before
+   including types.h to get the plain C library functions. */
+void *mem_malloc(size_t);
+void *mem_calloc(size_t, size_t);
+void *mem_realloc(void *, size_t);
+void mem_free(void *);
+
+size_t mem_current(void);
+size_t mem_peak(void);
+void mem_reset_peak(void);
+
+#ifndef MEM_NO_REDIRECT
+#define malloc(size)         mem_malloc(size)
+#define calloc(count, size)  mem_calloc(count, size)
+#define realloc(ptr, size)   mem_realloc(ptr, size)
+#define free(ptr)            mem_free(ptr)
+#endif
+
+#endif
@@ -0,0 +1,171 @@
+#include "types.h"
+#include "graph.h"
+#include "tc.h"
+#include "gen.h"
+#include "oracle.h"
+#ifdef PARALLEL
+#include "tc_parallel.h"
+#include <omp.h>
+#endif
+
+/* The oracle's "fast" kernel: the forward algorithm is O(m^1.5) and does
+   not degrade on high-degree vertices the way the wedge and edge-centric
+   kernels do. Parallel builds use its vertex-parallel version. */
+#ifdef PARALLEL
+#define ORACLE_FAST_KERNEL       tc_forward_hash_P
+#define ORACLE_FAST_KERNEL_NAME  "tc_forward_hash_P"
+#else
+#define ORACLE_FAST_KERNEL       tc_forward_hash
+#define ORACLE_FAST_KERNEL_NAME  "tc_forward_hash"
+#endif
+
+/* Sampled estimates accept counts within this many standard errors */
+#define ORACLE_SAMPLE_Z  4.0
+
+static enum oracleMode_t oracleMode = ORACLE_FAST;
+static bool haveTriangleCount = false;
+static UINT_t correctTriangleCount;
+static double sampleEstimate, sampleTolerance;
+
+/* Number of triangles that contain v */
+static UINT_t vertex_triangles(const GRAPH_TYPE *graph, const UINT_t v, bool *mark) {
+  const UINT_t* restrict Ap = graph->rowPtr;
+  const VERTEX_t* restrict Ai = graph->colInd;
+  UINT_t count = 0;
+
+  for (UINT_t i = Ap[v] ; i < Ap[v+1] ; i++)
+    mark[Ai[i]] = true;
+
+  for (UINT_t i = Ap[v] ; i < Ap[v+1] ; i++) {
+    const UINT_t u = Ai[i];
+    for (UINT_t j = Ap[u] ; j < Ap[u+1] ; j++)
+      if (mark[Ai[j]]) count++;
+  }
+
+  for (UINT_t i = Ap[v] ; i < Ap[v+1] ; i++)
+    mark[Ai[i]] = false;
+
+  return count / 2;
+}
+
+/* Estimate the triangle count as n/3 times the mean per-vertex count of a
+   uniform sample of vertices (each triangle has three vertices). */
+static void oracle_sample(const GRAPH_TYPE *graph, const UINT_t samples, const uint64_t seed) {
+  const UINT_t n = graph->numVertices;
+  double sum = 0.0, sumsq = 0.0;
+
+#ifdef PARALLEL
+#pragma omp parallel reduction(+:sum,sumsq)
+#endif
+  {
+    bool *mark = (bool *)calloc(n, sizeof(bool));
+    assert_malloc(mark);
+
+#ifdef PARALLEL
+#pragma omp for schedule(dynamic,16)
+#endif
+    for (UINT_t i = 0 ; i < samples ; i++) {
+      const UINT_t v = (UINT_t)(random_u64(seed, 0, i) % n);
+      const double t = (double)vertex_triangles(graph, v, mark);
+      sum += t;
+      sumsq += t * t;
+    }
+
+    free(mark);
+  }
+
+  const double mean = sum / samples;
+  const double var = (samples > 1) ? max(0.0, (sumsq - samples * mean * mean) / (samples - 1)) : 0.0;
+  sampleEstimate = (double)n / 3.0 * mean;
+  /* The standard error, plus the resolution of a single sampled triangle */
+  sampleTolerance = ORACLE_SAMPLE_Z * (double)n / 3.0 * sqrt(var / samples) + (double)n / (3.0 * samples);
+}
+
+static UINT_t oracle_read_file(const char *filename) {
+  unsigned long long count;
+
+  FILE *f = fopen(filename, "r");
+  if (f == NULL) {
+    fprintf(stderr,"ERROR: could not open triangle count file %s\n", filename);
+    exit(8);
+  }
+  if (fscanf(f, "%llu", &count) != 1) {
+    fprintf(stderr,"ERROR: triangle count file %s does not start with a count\n", filename);
+    exit(8);
+  }
+  fclose(f);
+  return (UINT_t)count;
+}
+
+/* Establish the reference count before any kernel is benchmarked:
+   ORACLE_FAST    run ORACLE_FAST_KERNEL
+   ORACLE_WEDGE   run tc_wedge, as the benchmark always used to
+   ORACLE_FILE    read the count from the file named by arg
+   ORACLE_SAMPLE  estimate the count from the per-vertex counts of samples
+                  random vertices; every kernel result is accepted within
+                  the estimate's error bounds, and none becomes an exact
+                  reference for the others
+   ORACLE_NONE    do not check */
+void oracle_init(const GRAPH_TYPE *graph, const enum oracleMode_t mode, const char *arg, const UINT_t samples, const uint64_t seed) {
+  double oracle_time = get_seconds();
+
+  oracleMode = mode;
+  haveTriangleCount = false;
+
+  switch (mode) {
+  case ORACLE_FAST:
+    correctTriangleCount = ORACLE_FAST_KERNEL(graph);
+    haveTriangleCount = true;
+    break;
+  case ORACLE_WEDGE:
+    correctTriangleCount = tc_wedge(graph);
+    haveTriangleCount = true;
+    break;
+  case ORACLE_FILE:
+    correctTriangleCount = oracle_read_file(arg);
+    haveTriangleCount = true;
+    break;
+  case ORACLE_SAMPLE:
+    if (graph->numVertices > 0)
+      oracle_sample(graph, samples, seed);
+    else
+      sampleEstimate = sampleTolerance = 0.0;
+    break;
+  case ORACLE_NONE:
+    break;
+  }
+
+  oracle_time = get_seconds() - oracle_time;
+
+  if (QUIET) return;
+
+  switch (mode) {
+  case ORACLE_FAST:
+    printf("Oracle (%s): %" PRIUINT " triangles in %9.6f s\n", ORACLE_FAST_KERNEL_NAME, correctTriangleCount, oracle_time);
+    break;
+  case ORACLE_WEDGE:
+    printf("Oracle (tc_wedge): %" PRIUINT " triangles in %9.6f s\n", correctTriangleCount, oracle_time);
+    break;
+  case ORACLE_FILE:
+    printf("Oracle (%s): %" PRIUINT " triangles\n", arg, correctTriangleCount);
+    break;
+  case ORACLE_SAMPLE:
+    printf("Oracle (%" PRIUINT " sampled vertices): %.0f +/- %.0f triangles in %9.6f s\n", samples, sampleEstimate, sampleTolerance, oracle_time);
+    break;
+  case ORACLE_NONE:
+    printf("Oracle: triangle counts are not checked\n");
+    break;
+  }
+}
+
+/* Check the correctness of the triangle count.
+   Return 1 if worked, 0 if failed */
+bool check_triangleCount(const UINT_t numTriangles) {
+  if (oracleMode == ORACLE_NONE)
+    return true;
+
+  if (!haveTriangleCount)
+    return (fabs((double)numTriangles - sampleEstimate) <= sampleTolerance);
+
+  return (numTriangles==correctTriangleCount);
+}
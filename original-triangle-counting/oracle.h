@@ -0,0 +1,12 @@
+#ifndef _ORACLE_H
+#define _ORACLE_H
+
+/* How the reference triangle count that every kernel is checked against
+   is established (-c) */
+enum oracleMode_t { ORACLE_FAST = 0, ORACLE_WEDGE, ORACLE_FILE, ORACLE_SAMPLE, ORACLE_NONE };
+
+#define ORACLE_DEFAULT_SAMPLES  1000
+
+void oracle_init(const GRAPH_TYPE *, const enum oracleMode_t, const char *, const UINT_t, const uint64_t);
+
+#endif
@@ -0,0 +1,204 @@
+#include "types.h"
+#include "perf.h"
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+#ifdef PARALLEL
+#include <omp.h>
+#endif
+
+/* Counters are opened per thread (perf_event_open counts one thread at a
+   time without privileges), the first time a thread is seen by
+   perf_start(). They are enabled, disabled and read by the main thread
+   through the file descriptors and summed over all threads, so the counts
+   cover every thread of the OpenMP pool. */
+
+const char *perfEventName[PERF_NUM_EVENTS] = { "cycles", "instructions", "llc_misses", "dtlb_misses", "branch_misses" };
+
+#define PERF_MAX_THREADS  4096
+
+typedef struct {
+  int fd[PERF_NUM_EVENTS];
+} perfThread_t;
+
+static bool perfOn = false;
+static bool perfAvailable[PERF_NUM_EVENTS];
+static perfThread_t *perfThreads[PERF_MAX_THREADS];
+static int perfNumThreads = 0;
+static __thread perfThread_t *perfSelf = NULL;
+
+#ifdef __linux__
+static const struct { uint32_t type; uint64_t config; } perfEventConfig[PERF_NUM_EVENTS] = {
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+  { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+  { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+};
+
+static int perf_open_event(const int e) {
+  struct perf_event_attr attr;
+
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = perfEventConfig[e].type;
+  attr.config = perfEventConfig[e].config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+  return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+/* Open the counters of the calling thread */
+static void perf_open_thread(void) {
+  perfThread_t *self = (perfThread_t *)malloc(sizeof(perfThread_t));
+  assert_malloc(self);
+
+  for (int e = 0 ; e < PERF_NUM_EVENTS ; e++) {
+    self->fd[e] = -1;
+#ifdef __linux__
+    if (perfAvailable[e])
+      self->fd[e] = perf_open_event(e);
+#endif
+  }
+  perfSelf = self;
+
+#ifdef PARALLEL
+#pragma omp critical
+#endif
+  {
+    if (perfNumThreads < PERF_MAX_THREADS)
+      perfThreads[perfNumThreads++] = self;
+  }
+}
+
+/* Returns false, after saying why unless QUIET, if no event can be counted */
+bool perf_init(void) {
+  perfOn = false;
+
+#ifdef __linux__
+  bool any = false;
+  int err = 0;
+  for (int e = 0 ; e < PERF_NUM_EVENTS ; e++) {
+    const int fd = perf_open_event(e);
+    perfAvailable[e] = (fd >= 0);
+    if (fd >= 0) {
+      close(fd);
+      any = true;
+    }
+    else
+      err = errno;
+  }
+
+  if (!any) {
+    if (!QUIET)
+      fprintf(stderr,"Hardware counters unavailable (%s), see /proc/sys/kernel/perf_event_paranoid\n", strerror(err));
+    return false;
+  }
+  if (!QUIET)
+    for (int e = 0 ; e < PERF_NUM_EVENTS ; e++)
+      if (!perfAvailable[e])
+	fprintf(stderr,"Hardware counter %s unavailable\n", perfEventName[e]);
+
+  perfOn = true;
+  perf_open_thread();
+  return true;
+#else
+  if (!QUIET)
+    fprintf(stderr,"Hardware counters are only supported on Linux\n");
+  return false;
+#endif
+}
+
+bool perf_enabled(void) {
+  return perfOn;
+}
+
+static void perf_ioctl(const unsigned long request) {
+#ifdef __linux__
+  for (int t = 0 ; t < perfNumThreads ; t++)
+    for (int e = 0 ; e < PERF_NUM_EVENTS ; e++)
+      if (perfThreads[t]->fd[e] >= 0)
+	ioctl(perfThreads[t]->fd[e], request, 0);
+#endif
+}
+
+/* Zero the counts of all threads, and open counters on any new thread of
+   the OpenMP pool */
+void perf_reset(void) {
+  if (!perfOn) return;
+#ifdef PARALLEL
+#pragma omp parallel
+  {
+    if (perfSelf == NULL)
+      perf_open_thread();
+  }
+#endif
+#ifdef __linux__
+  perf_ioctl(PERF_EVENT_IOC_RESET);
+#endif
+}
+
+void perf_start(void) {
+  if (!perfOn) return;
+#ifdef __linux__
+  perf_ioctl(PERF_EVENT_IOC_ENABLE);
+#endif
+}
+
+void perf_stop(void) {
+  if (!perfOn) return;
+#ifdef __linux__
+  perf_ioctl(PERF_EVENT_IOC_DISABLE);
+#endif
+}
+
+/* Counts since perf_reset(), summed over all threads and scaled up when
+   the kernel multiplexed the counters. An event is valid only if it was
+   counted on every thread: a sum missing some threads would look like a
+   real, smaller count. */
+void perf_read(perfCounts_t *counts) {
+  for (int e = 0 ; e < PERF_NUM_EVENTS ; e++) {
+    counts->valid[e] = perfOn && perfAvailable[e];
+    counts->count[e] = 0;
+  }
+  if (!perfOn) return;
+
+#ifdef __linux__
+  for (int t = 0 ; t < perfNumThreads ; t++)
+    for (int e = 0 ; e < PERF_NUM_EVENTS ; e++) {
+      uint64_t value[3];  /* count, time enabled, time running */
+      if (perfThreads[t]->fd[e] < 0) {
+	counts->valid[e] = false;
+	continue;
+      }
+      if (read(perfThreads[t]->fd[e], value, sizeof(value)) != sizeof(value)) {
+	counts->valid[e] = false;
+	continue;
+      }
+      if ((value[2] > 0) && (value[2] < value[1]))
+	value[0] = (uint64_t)((double)value[0] * (double)value[1] / (double)value[2]);
+      counts->count[e] += value[0];
+    }
+#endif
+}
+
+void perf_close(void) {
+#ifdef __linux__
+  for (int t = 0 ; t < perfNumThreads ; t++)
+    for (int e = 0 ; e < PERF_NUM_EVENTS ; e++)
+      if (perfThreads[t]->fd[e] >= 0)
+	close(perfThreads[t]->fd[e]);
+#endif
+  for (int t = 0 ; t < perfNumThreads ; t++)
+    free(perfThreads[t]);
+  perfNumThreads = 0;
+  perfOn = false;
+}
@@ -0,0 +1,23 @@
+#ifndef _PERF_H
+#define _PERF_H
+
+/* Hardware performance counters around each kernel call (-H) */
+enum perfEvent_t { PERF_CYCLES = 0, PERF_INSTRUCTIONS, PERF_LLC_MISSES, PERF_DTLB_MISSES, PERF_BRANCH_MISSES,
+		   PERF_NUM_EVENTS };
+
+typedef struct {
+  bool valid[PERF_NUM_EVENTS];     /* false if the event could not be counted */
+  uint64_t count[PERF_NUM_EVENTS];
+} perfCounts_t;
+
+extern const char *perfEventName[PERF_NUM_EVENTS];
+
+bool perf_init(void);
+bool perf_enabled(void);
+void perf_reset(void);
+void perf_start(void);
+void perf_stop(void);
+void perf_read(perfCounts_t *);
+void perf_close(void);
+
+#endif
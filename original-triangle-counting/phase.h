@@ -0,0 +1,29 @@
+#ifndef _PHASE_H
+#define _PHASE_H
+
+/* Phase timers inside the kernels, compiled in with -DPHASE_TIMERS.
+   PHASE(p) charges the time since the previous mark to phase p, so
+   nested kernel calls (e.g. tc_forward_hash inside a degree-order
+   wrapper) charge their own phases. The harness sets the mark right
+   before each kernel call. Only use PHASE() outside parallel regions. */
+enum phase_t { PHASE_PREPROCESS = 0, PHASE_BFS, PHASE_PARTITION, PHASE_COUNT, PHASE_CLEANUP, PHASE_NUM };
+
+#define PHASE_NAMES  { "preprocess", "bfs", "partition", "count", "cleanup" }
+
+#ifdef PHASE_TIMERS
+extern double phaseTime[PHASE_NUM];
+extern double phaseMark;
+
+#define PHASE_START()  (phaseMark = get_seconds())
+#define PHASE(p)						\
+  do {								\
+    const double phaseNow = get_seconds();			\
+    phaseTime[p] += phaseNow - phaseMark;			\
+    phaseMark = phaseNow;					\
+  } while (0)
+#else
+#define PHASE_START()
+#define PHASE(p)
+#endif
+
+#endif
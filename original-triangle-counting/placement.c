@@ -0,0 +1,208 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include "types.h"
+#include "graph.h"
+#include "placement.h"
+#include <sched.h>
+#include <unistd.h>
+#ifdef HAVE_LIBNUMA
+#include <numa.h>
+#endif
+#ifdef PARALLEL
+#include <omp.h>
+#endif
+
+/* Graph placement for multi-socket machines. Without libnuma (build with
+   -DHAVE_LIBNUMA -lnuma) the machine is treated as a single node: thread
+   binding and first-touch still work, interleaving and replicas do not. */
+
+#define PLACEMENT_MAX_NODES  64
+
+static int numNodes = 1;
+static bool bindOn = false;
+static int numCpus = 0;
+static int *cpuList = NULL;       /* CPUs in binding order, grouped by node */
+static int *cpuNode = NULL;       /* node of cpuList[i] */
+
+static GRAPH_TYPE *replica[PLACEMENT_MAX_NODES];
+static int numReplicas = 0;
+static __thread int threadNode = -1;
+
+static int node_of_cpu(const int cpu) {
+#ifdef HAVE_LIBNUMA
+  if (numNodes > 1) {
+    const int node = numa_node_of_cpu(cpu);
+    if (node >= 0) return node;
+  }
+#endif
+  (void)cpu;
+  return 0;
+}
+
+/* Find the nodes and the CPUs this process may run on, in node order */
+void placement_init(const bool bind) {
+  cpu_set_t mask;
+
+#ifdef HAVE_LIBNUMA
+  if (numa_available() >= 0)
+    numNodes = min(numa_num_configured_nodes(), PLACEMENT_MAX_NODES);
+#endif
+
+  CPU_ZERO(&mask);
+  if (sched_getaffinity(0, sizeof(mask), &mask) != 0)
+    CPU_SET(sched_getcpu(), &mask);
+
+  cpuList = (int *)malloc(CPU_SETSIZE * sizeof(int));
+  assert_malloc(cpuList);
+  cpuNode = (int *)malloc(CPU_SETSIZE * sizeof(int));
+  assert_malloc(cpuNode);
+  numCpus = 0;
+  for (int node = 0 ; node < numNodes ; node++)
+    for (int cpu = 0 ; cpu < CPU_SETSIZE ; cpu++)
+      if (CPU_ISSET(cpu, &mask) && (node_of_cpu(cpu) == node)) {
+	cpuList[numCpus] = cpu;
+	cpuNode[numCpus++] = node;
+      }
+
+  bindOn = bind && (numCpus > 0);
+
+  if (!QUIET)
+    printf("NUMA: %d node%s%s, %d CPUs%s\n", numNodes, (numNodes > 1) ? "s" : "",
+#ifdef HAVE_LIBNUMA
+	   "",
+#else
+	   " (built without libnuma)",
+#endif
+	   numCpus, bindOn ? ", threads bound in node order" : "");
+}
+
+/* Bind OpenMP thread i of a team of numThreads to the i-th CPU, so that
+   consecutive threads (and the blocks of a static schedule) fill one node
+   before the next */
+static void bind_team(const int numThreads) {
+  if (!bindOn) return;
+
+#ifdef PARALLEL
+#pragma omp parallel num_threads(numThreads)
+#endif
+  {
+#ifdef PARALLEL
+    const int i = omp_get_thread_num() % numCpus;
+#else
+    const int i = 0;
+#endif
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(cpuList[i], &mask);
+    sched_setaffinity(0, sizeof(mask), &mask);
+    threadNode = cpuNode[i];
+  }
+  (void)numThreads;
+}
+
+/* Called before each kernel, as the thread count may have changed */
+void bind_threads(void) {
+#ifdef PARALLEL
+  bind_team(omp_get_max_threads());
+#else
+  bind_team(1);
+#endif
+}
+
+/* Copy src into dst with each thread writing, and so first touching, the
+   rows of its block of a static schedule over the vertices */
+static void first_touch_copy(const GRAPH_TYPE *src, GRAPH_TYPE *dst, const int numThreads) {
+  const UINT_t* restrict Ap = src->rowPtr;
+  const UINT_t n = src->numVertices;
+
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static,1) num_threads(numThreads)
+#endif
+  for (int t = 0 ; t < numThreads ; t++) {
+    const UINT_t vb = (UINT_t)((uint64_t)n * t / numThreads);
+    const UINT_t ve = (UINT_t)((uint64_t)n * (t + 1) / numThreads);
+    memcpy(dst->rowPtr + vb, Ap + vb, (ve - vb + (t == numThreads - 1)) * sizeof(UINT_t));
+    memcpy(dst->colInd + Ap[vb], src->colInd + Ap[vb], (Ap[ve] - Ap[vb]) * sizeof(VERTEX_t));
+  }
+}
+
+/* Return a copy of graph placed according to mode. numThreads is the
+   thread count the kernels will run with, whose static blocks first-touch
+   follows. With PLACE_REPLICATE there is one copy per node, and kernels
+   find the copy of their node with local_graph(). Release with
+   free_placed_graph(). */
+GRAPH_TYPE *place_graph(const GRAPH_TYPE *graph, enum placement_t mode, const int numThreads, const bool readOnly) {
+  const UINT_t n = graph->numVertices;
+  const UINT_t m = graph->numEdges;
+
+  numReplicas = ((mode == PLACE_REPLICATE) && (numNodes > 1)) ? numNodes : 1;
+#ifndef HAVE_LIBNUMA
+  if ((mode == PLACE_INTERLEAVE) || (mode == PLACE_REPLICATE))
+    fprintf(stderr,"Warning: %s needs libnuma, using first-touch placement\n",
+	    (mode == PLACE_INTERLEAVE) ? "interleaving" : "replication");
+  mode = PLACE_FIRST_TOUCH;
+#endif
+
+  bind_team(max(numThreads, 1));
+
+  for (int r = 0 ; r < numReplicas ; r++) {
+    GRAPH_TYPE *copy = map_graph(n, m);
+#ifdef HAVE_LIBNUMA
+    const size_t rowPtrBytes = (n + 1) * sizeof(UINT_t);
+    const size_t colIndBytes = m * sizeof(VERTEX_t);
+    if ((mode == PLACE_INTERLEAVE) && (numNodes > 1)) {
+      numa_interleave_memory(copy->rowPtr, rowPtrBytes, numa_all_nodes_ptr);
+      numa_interleave_memory(copy->colInd, colIndBytes, numa_all_nodes_ptr);
+    }
+    if (numReplicas > 1) {
+      numa_tonode_memory(copy->rowPtr, rowPtrBytes, r);
+      numa_tonode_memory(copy->colInd, colIndBytes, r);
+    }
+#endif
+    first_touch_copy(graph, copy, max(numThreads, 1));
+    if (readOnly)
+      readonly_graph(copy);
+    replica[r] = copy;
+  }
+
+  if (!QUIET) {
+    static const char *placementName[] = { "none", "interleaved", "first-touch", "replicated" };
+    printf("Graph placement: %s", placementName[mode]);
+    if (numReplicas > 1)
+      printf(", %d replicas", numReplicas);
+    printf(", first touch by %d threads\n", max(numThreads, 1));
+  }
+
+  return replica[0];
+}
+
+void free_placed_graph(GRAPH_TYPE *graph) {
+  for (int r = 0 ; r < numReplicas ; r++)
+    free_protected_graph(replica[r]);
+  if (numReplicas == 0)
+    free_protected_graph(graph);
+  numReplicas = 0;
+}
+
+/* The replica of graph on the node of the calling thread */
+const GRAPH_TYPE *local_graph(const GRAPH_TYPE *graph) {
+  if ((numReplicas < 2) || (graph != replica[0]))
+    return graph;
+  int node = threadNode;
+  if (node < 0)
+    node = threadNode = node_of_cpu(sched_getcpu());
+  return replica[node % numReplicas];
+}
+
+/* Is graph the same graph as of, or one of its replicas */
+bool is_replica_of(const GRAPH_TYPE *graph, const GRAPH_TYPE *of) {
+  if (graph == of)
+    return true;
+  if ((numReplicas < 2) || (of != replica[0]))
+    return false;
+  for (int r = 1 ; r < numReplicas ; r++)
+    if (graph == replica[r])
+      return true;
+  return false;
+}
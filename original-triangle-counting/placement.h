@@ -0,0 +1,14 @@
+#ifndef _PLACEMENT_H
+#define _PLACEMENT_H
+
+/* NUMA placement of the input graph (-N) */
+enum placement_t { PLACE_NONE = 0, PLACE_INTERLEAVE, PLACE_FIRST_TOUCH, PLACE_REPLICATE };
+
+void placement_init(const bool);
+GRAPH_TYPE *place_graph(const GRAPH_TYPE *, enum placement_t, const int, const bool);
+void free_placed_graph(GRAPH_TYPE *);
+const GRAPH_TYPE *local_graph(const GRAPH_TYPE *);
+bool is_replica_of(const GRAPH_TYPE *, const GRAPH_TYPE *);
+void bind_threads(void);
+
+#endif
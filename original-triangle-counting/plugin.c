@@ -0,0 +1,85 @@
+#include "types.h"
+#include "graph.h"
+#include "plugin.h"
+#include <dlfcn.h>
+
+static plugin_t plugins[PLUGIN_MAX];
+static int numPlugins = 0;
+
+void plugin_load(const char *spec) {
+  if (numPlugins == PLUGIN_MAX) {
+    fprintf(stderr,"ERROR: More than %d plugins\n", PLUGIN_MAX);
+    exit(8);
+  }
+
+  char *path = (char *)malloc(strlen(spec) + 1);
+  assert_malloc(path);
+  strcpy(path, spec);
+  const char *symbol = PLUGIN_DEFAULT_SYMBOL;
+  char *colon = strrchr(path, ':');
+  if ((colon != NULL) && (strchr(colon, '/') == NULL)) {
+    *colon = '\0';
+    symbol = colon + 1;
+  }
+
+  /* RTLD_LOCAL keeps the kernels of different plugins apart */
+  void *handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+  if (handle == NULL) {
+    fprintf(stderr,"ERROR: Cannot load plugin %s: %s\n", path, dlerror());
+    exit(8);
+  }
+  const pluginAbi_t *abi = (const pluginAbi_t *)dlsym(handle, PLUGIN_ABI_SYMBOL);
+  if (abi == NULL) {
+    fprintf(stderr,"ERROR: Plugin %s has no %s, build it with make plugin\n", path, PLUGIN_ABI_SYMBOL);
+    exit(8);
+  }
+  if ((abi->uintBytes != sizeof(UINT_t)) || (abi->vertexBytes != sizeof(VERTEX_t))) {
+    fprintf(stderr,"ERROR: Plugin %s has %" PRIu32 "-byte UINT_t and %" PRIu32 "-byte VERTEX_t, tc has %zu and %zu;"
+	    " build both with the same WIDE\n", path, abi->uintBytes, abi->vertexBytes, sizeof(UINT_t), sizeof(VERTEX_t));
+    exit(8);
+  }
+
+  dlerror();
+  void *f = dlsym(handle, symbol);
+  const char *err = dlerror();
+  if ((err != NULL) || (f == NULL)) {
+    fprintf(stderr,"ERROR: Plugin %s has no kernel %s\n", path, symbol);
+    exit(8);
+  }
+
+  const char *base = strrchr(path, '/');
+  base = (base == NULL) ? path : base + 1;
+  size_t len = strlen(base);
+  if ((len > 3) && (strcmp(base + len - 3, ".so") == 0)) len -= 3;
+
+  char *name = (char *)malloc(len + strlen(symbol) + 2);
+  assert_malloc(name);
+  memcpy(name, base, len);
+  name[len] = '\0';
+  if (strcmp(symbol, PLUGIN_DEFAULT_SYMBOL) != 0) {
+    strcat(name, ":");
+    strcat(name, symbol);
+  }
+
+  plugins[numPlugins].name = name;
+  *(void **)&plugins[numPlugins].f = f;
+  plugins[numPlugins].handle = handle;
+  numPlugins++;
+  free(path);
+}
+
+int plugin_count(void) {
+  return numPlugins;
+}
+
+const plugin_t *plugin_get(const int i) {
+  return &plugins[i];
+}
+
+void plugin_unload_all(void) {
+  for (int i = 0 ; i < numPlugins ; i++) {
+    dlclose(plugins[i].handle);
+    free(plugins[i].name);
+  }
+  numPlugins = 0;
+}
@@ -0,0 +1,32 @@
+#ifndef _PLUGIN_H
+#define _PLUGIN_H
+
+/* Kernels loaded from shared objects (--plugin file[:symbol]), such as the
+   llm_variants built with make plugin. The symbol defaults to tc_fast_llm.
+   The plugins call back into tc (mem.h, graph.c, queue.c), so tc is
+   linked with -rdynamic. */
+#define PLUGIN_DEFAULT_SYMBOL  "tc_fast_llm"
+#define PLUGIN_MAX             64
+
+/* The widths of UINT_t and VERTEX_t a plugin was built with, exported as
+   PLUGIN_ABI_SYMBOL by plugin_abi.c. A plugin built with other widths
+   (WIDE, VERTEX32) would misread GRAPH_TYPE, so plugin_load refuses it. */
+#define PLUGIN_ABI_SYMBOL      "tc_plugin_abi"
+
+typedef struct {
+  uint32_t uintBytes;
+  uint32_t vertexBytes;
+} pluginAbi_t;
+
+typedef struct {
+  char *name;               /* file name without directory and .so, and :symbol if given */
+  UINT_t (*f)(const GRAPH_TYPE *);
+  void *handle;
+} plugin_t;
+
+void plugin_load(const char *);
+int plugin_count(void);
+const plugin_t *plugin_get(const int);
+void plugin_unload_all(void);
+
+#endif
@@ -0,0 +1,7 @@
+#include "types.h"
+#include "graph.h"
+#include "plugin.h"
+
+/* Compiled into every plugin (make plugin in llm_variants), not into tc:
+   the type widths the plugin was built with, for plugin_load to check */
+const pluginAbi_t tc_plugin_abi = { sizeof(UINT_t), sizeof(VERTEX_t) };
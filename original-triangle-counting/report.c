@@ -0,0 +1,242 @@
+#include "types.h"
+#include "graph.h"
+#include "perf.h"
+#include "phase.h"
+#include "intersect.h"
+#include "hub.h"
+#include "report.h"
+
+#if defined(__INTEL_LLVM_COMPILER)
+#define REPORT_COMPILER  "icx " __VERSION__
+#elif defined(__clang__)
+#define REPORT_COMPILER  "clang " __clang_version__
+#elif defined(__GNUC__)
+#define REPORT_COMPILER  "gcc " __VERSION__
+#else
+#define REPORT_COMPILER  "unknown"
+#endif
+
+#ifdef PARALLEL
+#define REPORT_PARALLEL  " PARALLEL"
+#else
+#define REPORT_PARALLEL  ""
+#endif
+#ifdef WIDE
+#define REPORT_WIDE      " WIDE"
+#else
+#define REPORT_WIDE      ""
+#endif
+#ifdef VERTEX32
+#define REPORT_VERTEX32  " VERTEX32"
+#else
+#define REPORT_VERTEX32  ""
+#endif
+#ifdef PHASE_TIMERS
+#define REPORT_PHASES    " PHASE_TIMERS"
+#else
+#define REPORT_PHASES    ""
+#endif
+/* The markers of the hash kernels (mark.h), always listed */
+#define REPORT_STR_(x)   #x
+#define REPORT_STR(x)    REPORT_STR_(x)
+#define REPORT_MARKS     " MARK_INTERSECT=" REPORT_STR(MARK_INTERSECT) " MARK_DAVIS=" REPORT_STR(MARK_DAVIS) \
+                         " MARK_BADER=" REPORT_STR(MARK_BADER) " MARK_FORWARD=" REPORT_STR(MARK_FORWARD)
+#define REPORT_DEFINES   REPORT_PARALLEL REPORT_WIDE REPORT_VERTEX32 REPORT_PHASES REPORT_MARKS
+
+/* Compile-time options, without the leading blank */
+static const char *reportDefines = REPORT_DEFINES + (sizeof(REPORT_DEFINES) > 1);
+
+/* Student's t, two-sided 95%, for 1..30 degrees of freedom */
+static const double tQuantile95[] = {
+  12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+   2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+   2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+
+static FILE *reportFile = NULL;
+static enum reportFormat_t reportFormat = REPORT_JSON;
+static const char *graphName = NULL;
+static UINT_t graphVertices, graphEdges;
+static uint64_t graphHash;
+#ifdef PHASE_TIMERS
+static const char *phaseName[PHASE_NUM] = PHASE_NAMES;
+#endif
+
+static int compareDouble(const void *a, const void *b) {
+  const double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+void compute_time_stats(const double *times, const int n, timeStats_t *stats) {
+  double *sorted = (double *)malloc(n * sizeof(double));
+  assert_malloc(sorted);
+  memcpy(sorted, times, n * sizeof(double));
+  qsort(sorted, n, sizeof(double), compareDouble);
+
+  double sum = 0.0;
+  for (int i = 0 ; i < n ; i++)
+    sum += sorted[i];
+  stats->mean = sum / (double)n;
+  stats->min = sorted[0];
+  stats->median = (n & 1) ? sorted[n/2] : 0.5 * (sorted[n/2 - 1] + sorted[n/2]);
+
+  double ss = 0.0;
+  for (int i = 0 ; i < n ; i++)
+    ss += (sorted[i] - stats->mean) * (sorted[i] - stats->mean);
+  stats->stddev = (n > 1) ? sqrt(ss / (double)(n - 1)) : 0.0;
+  stats->ci95 = (n > 1) ? ((n - 1 <= 30) ? tQuantile95[n - 2] : 1.96) * stats->stddev / sqrt((double)n) : 0.0;
+
+  free(sorted);
+}
+
+/* Strings are file names and kernel names; only quotes, backslashes and
+   control characters need escaping. */
+static void print_json_string(FILE *f, const char *s) {
+  fputc('"', f);
+  for ( ; *s ; s++) {
+    if ((*s == '"') || (*s == '\\'))
+      fprintf(f, "\\%c", *s);
+    else if ((unsigned char)*s < 0x20)
+      fprintf(f, "\\u%04x", (unsigned char)*s);
+    else
+      fputc(*s, f);
+  }
+  fputc('"', f);
+}
+
+static void print_csv_string(FILE *f, const char *s) {
+  fputc('"', f);
+  for ( ; *s ; s++) {
+    if (*s == '"') fputc('"', f);
+    fputc(*s, f);
+  }
+  fputc('"', f);
+}
+
+void report_open(const char *filename) {
+  const size_t len = strlen(filename);
+  reportFormat = ((len >= 4) && (strcmp(filename + len - 4, ".csv") == 0)) ? REPORT_CSV : REPORT_JSON;
+
+  reportFile = fopen(filename, "a");
+  if (reportFile == NULL) {
+    fprintf(stderr,"ERROR: Cannot open %s\n", filename);
+    exit(8);
+  }
+
+  fseek(reportFile, 0, SEEK_END);
+  if ((reportFormat == REPORT_CSV) && (ftell(reportFile) == 0))
+    fprintf(reportFile,"graph,n,m,hash,kernel,parallel,threads,triangles,correct,loops,"
+	    "min,median,mean,stddev,ci95,triangles_per_sec,edges_per_sec,"
+	    "cycles,instructions,llc_misses,dtlb_misses,branch_misses,"
+	    "preprocess,bfs,partition,count,cleanup,peak_bytes,"
+	    "speedup,efficiency,speedup_serial,efficiency_serial,serial_kernel,"
+	    "uint_bits,vertex_bits,compiler,defines,intersect,crossovers,hubs,times\n");
+}
+
+void report_graph(const GRAPH_TYPE *graph, const char *name) {
+  if (reportFile == NULL) return;
+  graphName = name;
+  graphVertices = graph->numVertices;
+  graphEdges = graph->numEdges / 2;
+  graphHash = graph_fingerprint(graph);
+}
+
+/* Rates and speedups are based on the median time */
+void report_kernel(const kernelResult_t *r) {
+  if (reportFile == NULL) return;
+
+  const double trianglesPerSec = (r->stats.median > 0.0) ? (double)r->numTriangles / r->stats.median : 0.0;
+  const double edgesPerSec = (r->stats.median > 0.0) ? (double)graphEdges / r->stats.median : 0.0;
+  const bool haveOneThread = (r->oneThreadTime > 0.0) && (r->stats.median > 0.0);
+  const bool haveSerial = r->parallel && (r->serialTime > 0.0) && (r->stats.median > 0.0);
+  const double speedup = haveOneThread ? r->oneThreadTime / r->stats.median : 0.0;
+  const double speedupSerial = haveSerial ? r->serialTime / r->stats.median : 0.0;
+
+  if (reportFormat == REPORT_JSON) {
+    fprintf(reportFile,"{\"graph\":");
+    print_json_string(reportFile, graphName);
+    fprintf(reportFile,",\"n\":%" PRIUINT ",\"m\":%" PRIUINT ",\"hash\":\"%016" PRIx64 "\",\"kernel\":",
+	    graphVertices, graphEdges, graphHash);
+    print_json_string(reportFile, r->kernel);
+    fprintf(reportFile,",\"parallel\":%s,\"threads\":%d,\"triangles\":%" PRIUINT ",\"correct\":%s,\"loops\":%d,\"times\":[",
+	    r->parallel ? "true" : "false", r->threads, r->numTriangles, r->correct ? "true" : "false", r->loops);
+    for (int i = 0 ; i < r->loops ; i++)
+      fprintf(reportFile,"%s%.9f", i ? "," : "", r->times[i]);
+    fprintf(reportFile,"],\"min\":%.9f,\"median\":%.9f,\"mean\":%.9f,\"stddev\":%.9f,\"ci95\":%.9f",
+	    r->stats.min, r->stats.median, r->stats.mean, r->stats.stddev, r->stats.ci95);
+    fprintf(reportFile,",\"triangles_per_sec\":%.6e,\"edges_per_sec\":%.6e", trianglesPerSec, edgesPerSec);
+    if (perf_enabled())
+      for (int e = 0 ; e < PERF_NUM_EVENTS ; e++) {
+	if (r->perf.valid[e])
+	  fprintf(reportFile,",\"%s\":%" PRIu64, perfEventName[e], r->perf.count[e]);
+	else
+	  fprintf(reportFile,",\"%s\":null", perfEventName[e]);
+      }
+#ifdef PHASE_TIMERS
+    for (int p = 0 ; p < PHASE_NUM ; p++)
+      fprintf(reportFile,",\"phase_%s\":%.9f", phaseName[p], r->phase[p]);
+#endif
+    fprintf(reportFile,",\"peak_bytes\":%zu", r->peakBytes);
+    if (haveOneThread)
+      fprintf(reportFile,",\"speedup\":%.4f,\"efficiency\":%.4f", speedup, speedup / r->threads);
+    if (haveSerial) {
+      fprintf(reportFile,",\"speedup_serial\":%.4f,\"efficiency_serial\":%.4f,\"serial_kernel\":",
+	      speedupSerial, speedupSerial / r->threads);
+      print_json_string(reportFile, r->serialKernel);
+    }
+    fprintf(reportFile,",\"uint_bits\":%d,\"vertex_bits\":%d,\"compiler\":",
+	    (int)(8 * sizeof(UINT_t)), (int)(8 * sizeof(VERTEX_t)));
+    print_json_string(reportFile, REPORT_COMPILER);
+    fprintf(reportFile,",\"defines\":");
+    print_json_string(reportFile, reportDefines);
+    fprintf(reportFile,",\"intersect\":");
+    print_json_string(reportFile, intersect_isa_name());
+    fprintf(reportFile,",\"crossovers\":\"%g,%g\"", intersectHashRatio, intersectGallopRatio);
+    fprintf(reportFile,",\"hubs\":%" PRIUINT, hubBitmaps.numHubs);
+    fprintf(reportFile,"}\n");
+  }
+  else {
+    print_csv_string(reportFile, graphName);
+    fprintf(reportFile,",%" PRIUINT ",%" PRIUINT ",%016" PRIx64 ",%s,%d,%d,%" PRIUINT ",%d,%d",
+	    graphVertices, graphEdges, graphHash, r->kernel, r->parallel, r->threads, r->numTriangles, r->correct, r->loops);
+    fprintf(reportFile,",%.9f,%.9f,%.9f,%.9f,%.9f,%.6e,%.6e",
+	    r->stats.min, r->stats.median, r->stats.mean, r->stats.stddev, r->stats.ci95,
+	    trianglesPerSec, edgesPerSec);
+    for (int e = 0 ; e < PERF_NUM_EVENTS ; e++) {
+      fputc(',', reportFile);
+      if (r->perf.valid[e])
+	fprintf(reportFile,"%" PRIu64, r->perf.count[e]);
+    }
+    for (int p = 0 ; p < PHASE_NUM ; p++) {
+      fputc(',', reportFile);
+#ifdef PHASE_TIMERS
+      fprintf(reportFile,"%.9f", r->phase[p]);
+#endif
+    }
+    fprintf(reportFile,",%zu", r->peakBytes);
+    if (haveOneThread)
+      fprintf(reportFile,",%.4f,%.4f", speedup, speedup / r->threads);
+    else
+      fprintf(reportFile,",,");
+    if (haveSerial)
+      fprintf(reportFile,",%.4f,%.4f,%s", speedupSerial, speedupSerial / r->threads, r->serialKernel);
+    else
+      fprintf(reportFile,",,,");
+    fprintf(reportFile,",%d,%d,", (int)(8 * sizeof(UINT_t)), (int)(8 * sizeof(VERTEX_t)));
+    print_csv_string(reportFile, REPORT_COMPILER);
+    fputc(',', reportFile);
+    print_csv_string(reportFile, reportDefines);
+    fputc(',', reportFile);
+    print_csv_string(reportFile, intersect_isa_name());
+    fprintf(reportFile,",\"%g,%g\",%" PRIUINT ",\"", intersectHashRatio, intersectGallopRatio, hubBitmaps.numHubs);
+    for (int i = 0 ; i < r->loops ; i++)
+      fprintf(reportFile,"%s%.9f", i ? ";" : "", r->times[i]);
+    fprintf(reportFile,"\"\n");
+  }
+  fflush(reportFile);
+}
+
+void report_close(void) {
+  if (reportFile != NULL)
+    fclose(reportFile);
+  reportFile = NULL;
+}
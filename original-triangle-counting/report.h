@@ -0,0 +1,36 @@
+#ifndef _REPORT_H
+#define _REPORT_H
+
+/* Structured benchmark results (-O), one record per kernel, written as
+   JSON Lines or, for a .csv file name, as CSV. Needs perf.h and phase.h. */
+enum reportFormat_t { REPORT_JSON = 0, REPORT_CSV };
+
+typedef struct {
+  double min, median, mean, stddev;
+  double ci95;              /* half width of the 95% confidence interval of the mean */
+} timeStats_t;
+
+typedef struct {
+  const char *kernel;
+  bool parallel;
+  int threads;
+  int loops;
+  double *times;            /* seconds, one per timed run */
+  timeStats_t stats;
+  UINT_t numTriangles;
+  bool correct;
+  perfCounts_t perf;        /* hardware counters per run */
+  size_t peakBytes;         /* largest heap growth of a run */
+  double phase[PHASE_NUM];  /* seconds per run in each phase, with -DPHASE_TIMERS */
+  double oneThreadTime;     /* median of the 1-thread run of a sweep, 0 if none */
+  double serialTime;        /* median of the fastest serial kernel, 0 if none */
+  const char *serialKernel;
+} kernelResult_t;
+
+void compute_time_stats(const double *, const int, timeStats_t *);
+void report_open(const char *);
+void report_graph(const GRAPH_TYPE *, const char *);
+void report_kernel(const kernelResult_t *);
+void report_close(void);
+
+#endif
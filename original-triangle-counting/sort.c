@@ -0,0 +1,221 @@
+#include "types.h"
+#include "sort.h"
+#ifdef PARALLEL
+#include <omp.h>
+#endif
+
+#define RADIX_BITS     8
+#define RADIX_BUCKETS  (1 << RADIX_BITS)
+
+static int sort_num_threads(const size_t n) {
+#ifdef PARALLEL
+  /* Not worth waking up the team for small inputs */
+  return (n < 65536) ? 1 : omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+int edge_key_shift(const UINT_t n) {
+  int shift = 1;
+  while ((shift < 32) && (((uint64_t)1 << shift) < (uint64_t)n))
+    shift++;
+  return shift;
+}
+
+/* Exclusive prefix sum of a[0..n-1] in place; returns the total. Each thread
+   sums a contiguous block, the block sums are scanned, and then each thread
+   scans its own block starting from its block offset. */
+UINT_t prefix_sum(UINT_t *a, const UINT_t n) {
+  const int numThreads = sort_num_threads(n);
+  const UINT_t blockSize = (n + numThreads - 1) / numThreads;
+
+  UINT_t *offset = (UINT_t *)calloc(numThreads + 1, sizeof(UINT_t));
+  assert_malloc(offset);
+
+#ifdef PARALLEL
+#pragma omp parallel num_threads(numThreads)
+#endif
+  {
+#ifdef PARALLEL
+    const int t = omp_get_thread_num();
+#else
+    const int t = 0;
+#endif
+    const UINT_t lo = min(n, t * blockSize);
+    const UINT_t hi = min(n, lo + blockSize);
+    UINT_t sum = 0;
+    for (UINT_t i = lo ; i < hi ; i++)
+      sum += a[i];
+    offset[t+1] = sum;
+
+#ifdef PARALLEL
+#pragma omp barrier
+#pragma omp single
+#endif
+    for (int i = 0 ; i < numThreads ; i++)
+      offset[i+1] += offset[i];
+
+    sum = offset[t];
+    for (UINT_t i = lo ; i < hi ; i++) {
+      const UINT_t c = a[i];
+      a[i] = sum;
+      sum += c;
+    }
+  }
+
+  const UINT_t total = offset[numThreads];
+  free(offset);
+  return total;
+}
+
+/* Serial LSD radix sort of a[0..n-1] on the low keyBits bits, with tmp[] of
+   size n as the scatter buffer. Used for the long rows of a CSR graph, where
+   each row is sorted by a single thread. */
+void radix_sort_uint(VERTEX_t *a, VERTEX_t *tmp, const UINT_t n, const int keyBits) {
+  UINT_t hist[RADIX_BUCKETS];
+  VERTEX_t *src = a;
+  VERTEX_t *dst = tmp;
+
+  for (int shift = 0 ; shift < keyBits ; shift += RADIX_BITS) {
+    for (int b = 0 ; b < RADIX_BUCKETS ; b++)
+      hist[b] = 0;
+    for (UINT_t i = 0 ; i < n ; i++)
+      hist[(src[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+
+    UINT_t sum = 0;
+    bool trivial = false;
+    for (int b = 0 ; b < RADIX_BUCKETS ; b++) {
+      const UINT_t c = hist[b];
+      if (c == n) trivial = true;
+      hist[b] = sum;
+      sum += c;
+    }
+    if (trivial) continue;
+
+    for (UINT_t i = 0 ; i < n ; i++) {
+      const VERTEX_t k = src[i];
+      dst[hist[(k >> shift) & (RADIX_BUCKETS - 1)]++] = k;
+    }
+
+    VERTEX_t *swap = src;
+    src = dst;
+    dst = swap;
+  }
+
+  if (src != a)
+    memcpy(a, src, n * sizeof(VERTEX_t));
+}
+
+/* Parallel LSD radix sort of keys[0..n-1] on the low keyBits bits, using tmp[]
+   (also of size n) as the scatter buffer. Each thread histograms and then
+   scatters its own contiguous block, so the sort is stable. Passes where
+   every key has the same digit are skipped. */
+void radix_sort_u64(uint64_t *keys, uint64_t *tmp, const size_t n, const int keyBits) {
+  const int numThreads = sort_num_threads(n);
+  const size_t blockSize = (n + numThreads - 1) / numThreads;
+  uint64_t *src = keys;
+  uint64_t *dst = tmp;
+
+  size_t *hist = (size_t *)malloc(numThreads * RADIX_BUCKETS * sizeof(size_t));
+  assert_malloc(hist);
+
+  for (int shift = 0 ; shift < keyBits ; shift += RADIX_BITS) {
+
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static,1) num_threads(numThreads)
+#endif
+    for (int t = 0 ; t < numThreads ; t++) {
+      size_t *h = hist + t * RADIX_BUCKETS;
+      const size_t lo = min(n, t * blockSize);
+      const size_t hi = min(n, lo + blockSize);
+      for (int b = 0 ; b < RADIX_BUCKETS ; b++)
+	h[b] = 0;
+      for (size_t i = lo ; i < hi ; i++)
+	h[(src[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+    }
+
+    /* Exclusive scan in (bucket, thread) order gives each thread its write offsets */
+    size_t sum = 0;
+    bool trivial = false;
+    for (int b = 0 ; b < RADIX_BUCKETS ; b++) {
+      size_t bucket = 0;
+      for (int t = 0 ; t < numThreads ; t++) {
+	size_t c = hist[t * RADIX_BUCKETS + b];
+	hist[t * RADIX_BUCKETS + b] = sum;
+	sum += c;
+	bucket += c;
+      }
+      if (bucket == n) trivial = true;
+    }
+    if (trivial) continue;
+
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static,1) num_threads(numThreads)
+#endif
+    for (int t = 0 ; t < numThreads ; t++) {
+      size_t *h = hist + t * RADIX_BUCKETS;
+      const size_t lo = min(n, t * blockSize);
+      const size_t hi = min(n, lo + blockSize);
+      for (size_t i = lo ; i < hi ; i++) {
+	const uint64_t k = src[i];
+	dst[h[(k >> shift) & (RADIX_BUCKETS - 1)]++] = k;
+      }
+    }
+
+    uint64_t *swap = src;
+    src = dst;
+    dst = swap;
+  }
+
+  if (src != keys) {
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static) num_threads(numThreads)
+#endif
+    for (size_t i = 0 ; i < n ; i++)
+      keys[i] = src[i];
+  }
+
+  free(hist);
+}
+
+/* Copy the distinct keys of the sorted array in[0..n-1] to out[] and return
+   how many there are. */
+size_t unique_u64(const uint64_t *in, uint64_t *out, const size_t n) {
+  const int numThreads = sort_num_threads(n);
+  const size_t blockSize = (n + numThreads - 1) / numThreads;
+
+  size_t *offset = (size_t *)calloc(numThreads + 1, sizeof(size_t));
+  assert_malloc(offset);
+
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static,1) num_threads(numThreads)
+#endif
+  for (int t = 0 ; t < numThreads ; t++) {
+    const size_t lo = min(n, t * blockSize);
+    const size_t hi = min(n, lo + blockSize);
+    size_t c = 0;
+    for (size_t i = lo ; i < hi ; i++)
+      c += ((i == 0) || (in[i] != in[i-1]));
+    offset[t+1] = c;
+  }
+
+  for (int t = 0 ; t < numThreads ; t++)
+    offset[t+1] += offset[t];
+
+#ifdef PARALLEL
+#pragma omp parallel for schedule(static,1) num_threads(numThreads)
+#endif
+  for (int t = 0 ; t < numThreads ; t++) {
+    const size_t lo = min(n, t * blockSize);
+    const size_t hi = min(n, lo + blockSize);
+    size_t k = offset[t];
+    for (size_t i = lo ; i < hi ; i++)
+      if ((i == 0) || (in[i] != in[i-1]))
+	out[k++] = in[i];
+  }
+
+  size_t count = offset[numThreads];
+  free(offset);
+  return count;
+}
@@ -0,0 +1,16 @@
+#ifndef _SORT_H
+#define _SORT_H
+
+/* Edges are sorted as packed 64-bit keys (src << shift | dst), where shift
+   is the number of bits needed to hold a vertex ID. */
+int edge_key_shift(const UINT_t);
+#define EDGE_KEY(src, dst, shift)   (((uint64_t)(src) << (shift)) | (uint64_t)(dst))
+#define EDGE_KEY_SRC(key, shift)    ((UINT_t)((key) >> (shift)))
+#define EDGE_KEY_DST(key, shift)    ((UINT_t)((key) & ((((uint64_t)1) << (shift)) - 1)))
+
+UINT_t prefix_sum(UINT_t *, const UINT_t);
+void radix_sort_uint(VERTEX_t *, VERTEX_t *, const UINT_t, const int);
+void radix_sort_u64(uint64_t *, uint64_t *, const size_t, const int);
+size_t unique_u64(const uint64_t *, uint64_t *, const size_t);
+
+#endif
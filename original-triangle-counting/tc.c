@@ -2,6 +2,9 @@
 #include "queue.h"
 #include "graph.h"
 #include "bfs.h"
+#include "phase.h"
+#include "intersect.h"
+#include "hub.h"
 #include "tc.h"
 
 /* Algorithm from
@@ -20,29 +23,30 @@ const UINT_t n // A is n-by-n
 {
 #if 1
   UINT_t *Ap = graph->rowPtr;
-  UINT_t *Ai = graph->colInd;
+  VERTEX_t *Ai = graph->colInd;
   UINT_t n = graph->numVertices;
 #endif
-  bool *restrict Mark = (bool *) calloc (n, sizeof (bool)) ;
-  if (Mark == NULL) return (-1) ;
+  MARK_T(MARK_DAVIS) Mark ;
+  MARK(MARK_DAVIS, alloc) (&Mark, n) ;
   
   UINT_t ntri = 0 ;
   for (UINT_t j = 0 ; j < n ; j++) {
     // scatter A(:,j) into Mark
+    MARK(MARK_DAVIS, next) (&Mark) ;
     for (UINT_t p = Ap [j] ; p < Ap [j+1] ; p++)
-      Mark [Ai [p]] = 1 ;
+      MARK(MARK_DAVIS, set) (&Mark, Ai [p]) ;
     // sum(C(:,j)) where C(:,j) = (A * A(:,j)) .* Mark
     for (UINT_t p = Ap [j] ; p < Ap [j+1] ; p++) {
       const UINT_t k = Ai [p] ;
       // C(:,j) += (A(:,k) * A(k,j)) .* Mark
       for (UINT_t pa = Ap [k] ; pa < Ap [k+1] ; pa++)
 	// C(i,j) += (A(i,k) * A(k,j)) .* Mark
-	ntri += Mark [Ai [pa]] ;
+	ntri += MARK(MARK_DAVIS, test) (&Mark, Ai [pa]) ;
     }
     for (UINT_t p = Ap [j] ; p < Ap [j+1] ; p++)
-      Mark [Ai [p]] = 0 ;
+      MARK(MARK_DAVIS, unset) (&Mark, Ai [p]) ;
   }
-  free (Mark) ;
+  MARK(MARK_DAVIS, free) (&Mark) ;
   return (ntri/6) ;
 }
  
@@ -52,7 +56,7 @@ UINT_t tc_wedge(const GRAPH_TYPE *graph) {
   UINT_t count = 0;
 
   const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
+  const VERTEX_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   for (UINT_t i = 0; i < n; i++) {
@@ -90,7 +94,7 @@ UINT_t tc_wedge_DO(const GRAPH_TYPE *graph) {
   UINT_t count = 0;
 
   const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
+  const VERTEX_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   for (UINT_t i = 0; i < n; i++) {
@@ -177,7 +181,7 @@ UINT_t tc_intersectMergePath(const GRAPH_TYPE *graph) {
   UINT_t count = 0;
 
   const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
+  const VERTEX_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   for (v = 0; v < n; v++) {
@@ -201,7 +205,7 @@ UINT_t tc_intersectMergePath_DO(const GRAPH_TYPE *graph) {
   UINT_t count = 0;
 
   const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
+  const VERTEX_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   for (v = 0; v < n; v++) {
@@ -226,7 +230,7 @@ UINT_t tc_intersectBinarySearch(const GRAPH_TYPE *graph) {
   UINT_t count = 0;
 
   const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
+  const VERTEX_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   for (v = 0; v < n; v++) {
@@ -250,7 +254,7 @@ UINT_t tc_intersectBinarySearch_DO(const GRAPH_TYPE *graph) {
   UINT_t count = 0;
 
   const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
+  const VERTEX_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   for (v = 0; v < n; v++) {
@@ -275,7 +279,7 @@ UINT_t tc_intersectPartition(const GRAPH_TYPE *graph) {
   UINT_t count = 0;
 
   const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
+  const VERTEX_t *restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   for (v = 0; v < n ; v++) {
@@ -283,7 +287,7 @@ UINT_t tc_intersectPartition(const GRAPH_TYPE *graph) {
     e = Ap[v+1];
     for (UINT_t i=b ; i<e ; i++) {
       w  = Ai[i];
-      count += searchLists_with_partitioning((UINT_t *)Ai, (INT_t) Ap[v], (INT_t)Ap[v+1]-1, (UINT_t *)Ai, (INT_t)Ap[w], (INT_t)Ap[w+1]-1);
+      count += searchLists_with_partitioning(Ai, (INT_t) Ap[v], (INT_t)Ap[v+1]-1, Ai, (INT_t)Ap[w], (INT_t)Ap[w+1]-1);
     }
   }
 
@@ -299,7 +303,7 @@ UINT_t tc_intersectPartition_DO(const GRAPH_TYPE *graph) {
   UINT_t count = 0;
 
   const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
+  const VERTEX_t *restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   for (v = 0; v < n; v++) {
@@ -308,7 +312,7 @@ UINT_t tc_intersectPartition_DO(const GRAPH_TYPE *graph) {
     for (UINT_t i=b ; i<e ; i++) {
       w  = Ai[i];
       if (v < w)
-	count += searchLists_with_partitioning((UINT_t *)Ai, (INT_t) Ap[v], (INT_t)Ap[v+1]-1, (UINT_t *)Ai, (INT_t)Ap[w], (INT_t)Ap[w+1]-1);
+	count += searchLists_with_partitioning(Ai, (INT_t) Ap[v], (INT_t)Ap[v+1]-1, Ai, (INT_t)Ap[w], (INT_t)Ap[w+1]-1);
     }
   }
 
@@ -324,25 +328,24 @@ UINT_t tc_intersectHash(const GRAPH_TYPE *graph) {
   register UINT_t b, e;
   UINT_t count = 0;
 
-  bool *Hash;
+  MARK_T(MARK_INTERSECT) Hash;
 
   const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
+  const VERTEX_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
-  Hash = (bool *)calloc(n, sizeof(bool));
-  assert_malloc(Hash);
+  MARK(MARK_INTERSECT, alloc)(&Hash, n);
   
   for (v = 0; v < n ; v++) {
     b = Ap[v  ];
     e = Ap[v+1];
     for (UINT_t i=b ; i<e ; i++) {
       w  = Ai[i];
-      count += intersectSizeHash(graph, Hash, v, w);
+      count += intersectSizeHash(graph, &Hash, v, w);
     }
   }
 
-  free(Hash);
+  MARK(MARK_INTERSECT, free)(&Hash);
 
   return (count/6);
 }
@@ -356,15 +359,75 @@ UINT_t tc_intersectHash_DO(const GRAPH_TYPE *graph) {
   register UINT_t b, e;
   UINT_t count = 0;
 
-  bool *Hash;
+  MARK_T(MARK_INTERSECT) Hash;
 
   const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
+  const VERTEX_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
 
-  Hash = (bool *)calloc(n, sizeof(bool));
-  assert_malloc(Hash);
+  MARK(MARK_INTERSECT, alloc)(&Hash, n);
+  
+  for (v = 0; v < n ; v++) {
+    b = Ap[v  ];
+    e = Ap[v+1];
+    for (UINT_t i=b ; i<e ; i++) {
+      w  = Ai[i];
+      if (v < w)
+	count += intersectSizeHash(graph, &Hash, v, w);
+    }
+  }
+
+  MARK(MARK_INTERSECT, free)(&Hash);
+
+  return (count/3);
+}
+
+UINT_t tc_intersectAdaptive(const GRAPH_TYPE *graph) {
+  /* Algorithm: For each edge (i, j), find the size of its intersection using merge, hash or galloping by the ratio of the degrees. */
+
+  register UINT_t v, w;
+  register UINT_t b, e;
+  UINT_t count = 0;
+
+  MARK_T(MARK_INTERSECT) Hash;
+
+  const UINT_t* restrict Ap = graph->rowPtr;
+  const VERTEX_t* restrict Ai = graph->colInd;
+  const UINT_t n = graph->numVertices;
+
+  MARK(MARK_INTERSECT, alloc)(&Hash, n);
+  
+  for (v = 0; v < n ; v++) {
+    b = Ap[v  ];
+    e = Ap[v+1];
+    for (UINT_t i=b ; i<e ; i++) {
+      w  = Ai[i];
+      count += intersectSizeAdaptive(graph, &Hash, v, w);
+    }
+  }
+
+  MARK(MARK_INTERSECT, free)(&Hash);
+
+  return (count/6);
+}
+
+
+UINT_t tc_intersectAdaptive_DO(const GRAPH_TYPE *graph) {
+  /* Algorithm: For each edge (i, j), find the size of its intersection using merge, hash or galloping by the ratio of the degrees. */
+  /* Direction oriented. */
+
+  register UINT_t v, w;
+  register UINT_t b, e;
+  UINT_t count = 0;
+
+  MARK_T(MARK_INTERSECT) Hash;
+
+  const UINT_t* restrict Ap = graph->rowPtr;
+  const VERTEX_t* restrict Ai = graph->colInd;
+  const UINT_t n = graph->numVertices;
+
+  MARK(MARK_INTERSECT, alloc)(&Hash, n);
   
   for (v = 0; v < n ; v++) {
     b = Ap[v  ];
@@ -372,11 +435,11 @@ UINT_t tc_intersectHash_DO(const GRAPH_TYPE *graph) {
     for (UINT_t i=b ; i<e ; i++) {
       w  = Ai[i];
       if (v < w)
-	count += intersectSizeHash(graph, Hash, v, w);
+	count += intersectSizeAdaptive(graph, &Hash, v, w);
     }
   }
 
-  free(Hash);
+  MARK(MARK_INTERSECT, free)(&Hash);
 
   return (count/3);
 }
@@ -397,7 +460,7 @@ UINT_t tc_low(
 {
 #if 1
   UINT_t* IA = graph->rowPtr;
-  UINT_t* JA = graph->colInd;
+  VERTEX_t* JA = graph->colInd;
   UINT_t N = graph->numVertices;
 #endif
   UINT_t delta = 0 ; // number of triangles
@@ -409,9 +472,9 @@ UINT_t tc_low(
       UINT_t *curr_row_x = IA + i ;
       UINT_t *curr_row_A = IA + i + 1;
       UINT_t num_nnz_curr_row_x = *curr_row_A - *curr_row_x;
-      UINT_t *x_col_begin = ( JA + *curr_row_x);
-      UINT_t *x_col_end = x_col_begin;
-      UINT_t *row_bound = x_col_begin + num_nnz_curr_row_x;
+      VERTEX_t *x_col_begin = ( JA + *curr_row_x);
+      VERTEX_t *x_col_end = x_col_begin;
+      VERTEX_t *row_bound = x_col_begin + num_nnz_curr_row_x;
       // UINT_t col_x_min = 0;
       UINT_t col_x_max = i - 1;
 
@@ -420,23 +483,23 @@ UINT_t tc_low(
 	++x_col_end;
       x_col_end -= (*x_col_end > col_x_max || x_col_end == row_bound);
 
-      UINT_t *y_col_begin = x_col_end + 1;
-      UINT_t *y_col_end = row_bound - 1;
+      VERTEX_t *y_col_begin = x_col_end + 1;
+      VERTEX_t *y_col_end = row_bound - 1;
       UINT_t num_nnz_y = (y_col_end - y_col_begin) + 1;
       UINT_t num_nnz_x = (x_col_end - x_col_begin) + 1;
 
       UINT_t y_col_first = i + 1;
       UINT_t x_col_first = 0;
-      UINT_t *y_col = y_col_begin;
+      VERTEX_t *y_col = y_col_begin;
 
       // compute y*A20*x ( Equation 5 )
       for (UINT_t j = 0 ; j< num_nnz_y ; ++j ,++ y_col)
 	{
 	  UINT_t row_index_A = *y_col - y_col_first;
-	  UINT_t *x_col = x_col_begin;
+	  VERTEX_t *x_col = x_col_begin;
 	  UINT_t num_nnz_A = *( curr_row_A + row_index_A + 1 ) - *( curr_row_A + row_index_A );
-	  UINT_t *A_col = ( JA + *( curr_row_A + row_index_A ) );
-	  UINT_t *A_col_max = A_col + num_nnz_A ;
+	  VERTEX_t *A_col = ( JA + *( curr_row_A + row_index_A ) );
+	  VERTEX_t *A_col_max = A_col + num_nnz_A ;
 
 	  for (UINT_t k = 0 ; k < num_nnz_x && *A_col <= col_x_max ; ++k )
 	    {
@@ -458,7 +521,7 @@ void bfs_treelist(const GRAPH_TYPE *graph, const bool* E, UINT_t* parent /* , UI
   /* UINT_t c; */
   
   const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
+  const VERTEX_t *restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   bool *visited = (bool *)malloc(n * sizeof(bool));
@@ -509,7 +572,7 @@ static bool and_E(const bool* E, const UINT_t m) {
 static bool check_edge_treelist(const GRAPH_TYPE *graph, const bool* E, const UINT_t v, const UINT_t w) {
 
   const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
+  const VERTEX_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   if ((v==n) || (w==n)) return false;
@@ -526,7 +589,7 @@ static bool check_edge_treelist(const GRAPH_TYPE *graph, const bool* E, const UI
 static void remove_treelist(const GRAPH_TYPE* graph, bool *E, const UINT_t *parent) {
 
   const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
+  const VERTEX_t *restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   for (UINT_t v=0 ; v<n ; v++) {
@@ -561,7 +624,7 @@ UINT_t tc_treelist(const GRAPH_TYPE *graph) {
   // UINT_t* component;
   
   const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
+  const VERTEX_t *restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
 
@@ -626,7 +689,7 @@ static void bfs_treelist2(const GRAPH_TYPE *graph, UINT_t* parent /* , UINT_t* c
   /* UINT_t c; */
   
   const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
+  const VERTEX_t *restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   bool *visited = (bool *)malloc(n * sizeof(bool));
@@ -670,7 +733,7 @@ static void bfs_treelist2(const GRAPH_TYPE *graph, UINT_t* parent /* , UINT_t* c
 static void remove_treelist2(GRAPH_TYPE* graph, const UINT_t *parent) {
 
   UINT_t *restrict Ap = graph->rowPtr;
-  UINT_t *restrict Ai = graph->colInd;
+  VERTEX_t *restrict Ai = graph->colInd;
   UINT_t n = graph->numVertices;
   UINT_t m = graph->numEdges;
 
@@ -763,7 +826,7 @@ UINT_t tc_treelist2(const GRAPH_TYPE *graph) {
   copy_graph(graph, graph2);
   
   const UINT_t *restrict Ap2 = graph2->rowPtr;
-  const UINT_t *restrict Ai2 = graph2->colInd;
+  const VERTEX_t *restrict Ai2 = graph2->colInd;
 
   //  component = (UINT_t *)malloc(n * sizeof(UINT_t));
   //  assert_malloc(component);
@@ -818,7 +881,7 @@ UINT_t tc_forward(const GRAPH_TYPE *graph) {
   UINT_t count = 0;
 
   const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
+  const VERTEX_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
 
@@ -827,6 +890,7 @@ UINT_t tc_forward(const GRAPH_TYPE *graph) {
   
   UINT_t* A = (UINT_t *)calloc(m, sizeof(UINT_t));
   assert_malloc(A);
+  PHASE(PHASE_PREPROCESS);
 
   for (s = 0; s < n ; s++) {
     b = Ap[s  ];
@@ -840,9 +904,57 @@ UINT_t tc_forward(const GRAPH_TYPE *graph) {
       }
     }
   }
+  PHASE(PHASE_COUNT);
+
+  free(A);
+  free(Size);
+  PHASE(PHASE_CLEANUP);
+  
+  return count;
+}
+
+UINT_t tc_forward_adaptive(const GRAPH_TYPE *graph) {
+  
+/* Schank, T., Wagner, D. (2005). Finding, Counting and Listing All Triangles in Large Graphs, an Experimental Study. In: Nikoletseas, S.E. (eds) Experimental and Efficient Algorithms. WEA 2005. Lecture Notes in Computer Science, vol 3503. Springer, Berlin, Heidelberg. https://doi.org/10.1007/11427186_54 */
+/* Each intersection by merge, hash or galloping (intersect_method) */
+
+  register UINT_t s, t;
+  register UINT_t b, e;
+  UINT_t count = 0;
+
+  const UINT_t* restrict Ap = graph->rowPtr;
+  const VERTEX_t* restrict Ai = graph->colInd;
+  const UINT_t n = graph->numVertices;
+  const UINT_t m = graph->numEdges;
+
+  UINT_t* Size = (UINT_t *)calloc(n, sizeof(UINT_t));
+  assert_malloc(Size);
+  
+  UINT_t* A = (UINT_t *)calloc(m, sizeof(UINT_t));
+  assert_malloc(A);
+
+  MARK_T(MARK_INTERSECT) Hash;
+  MARK(MARK_INTERSECT, alloc)(&Hash, n);
+  PHASE(PHASE_PREPROCESS);
+
+  for (s = 0; s < n ; s++) {
+    b = Ap[s  ];
+    e = Ap[s+1];
+    for (UINT_t i=b ; i<e ; i++) {
+      t  = Ai[i];
+      if (s<t) {
+	count += intersectSizeAdaptive_forward(graph, &Hash, s, t, A, Size);
+	A[Ap[t] + Size[t]] = s;
+	Size[t]++;
+      }
+    }
+  }
+  PHASE(PHASE_COUNT);
 
+  MARK(MARK_INTERSECT, free)(&Hash);
   free(A);
   free(Size);
+  PHASE(PHASE_CLEANUP);
   
   return count;
 }
@@ -856,18 +968,19 @@ static UINT_t tc_forward_hash_config_size(const GRAPH_TYPE *graph, UINT_t hashSi
   UINT_t count = 0;
 
   const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
+  const VERTEX_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
 
-  bool* Hash = (bool *)calloc( (hashSize == 0)? m: hashSize, sizeof(bool));
-  assert_malloc(Hash);
+  MARK_T(MARK_INTERSECT) Hash;
+  MARK(MARK_INTERSECT, alloc)(&Hash, (hashSize == 0) ? n : hashSize);
 
   UINT_t* Size = (UINT_t *)calloc(n, sizeof(UINT_t));
   assert_malloc(Size);
   
   UINT_t* A = (UINT_t *)calloc(m, sizeof(UINT_t));
   assert_malloc(A);
+  PHASE(PHASE_PREPROCESS);
 
   for (s = 0; s < n ; s++) {
     b = Ap[s  ];
@@ -875,16 +988,18 @@ static UINT_t tc_forward_hash_config_size(const GRAPH_TYPE *graph, UINT_t hashSi
     for (UINT_t i=b ; i<e ; i++) {
       t  = Ai[i];
       if (s<t) {
-	count += intersectSizeHash_forward(graph, Hash, s, t, A, Size);
+	count += intersectSizeHash_forward(graph, &Hash, s, t, A, Size);
 	A[Ap[t] + Size[t]] = s;
 	Size[t]++;
       }
     }
   }
+  PHASE(PHASE_COUNT);
 
   free(A);
   free(Size);
-  free(Hash);
+  MARK(MARK_INTERSECT, free)(&Hash);
+  PHASE(PHASE_CLEANUP);
   
   return count;
 }
@@ -902,18 +1017,19 @@ static UINT_t tc_forward_hash_skip_config_size(const GRAPH_TYPE *graph, UINT_t h
   UINT_t count = 0;
 
   const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
+  const VERTEX_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
 
-  bool* Hash = (bool *)calloc( (hashSize == 0)? m: hashSize, sizeof(bool));
-  assert_malloc(Hash);
+  MARK_T(MARK_INTERSECT) Hash;
+  MARK(MARK_INTERSECT, alloc)(&Hash, (hashSize == 0) ? n : hashSize);
 
   UINT_t* Size = (UINT_t *)calloc(n, sizeof(UINT_t));
   assert_malloc(Size);
 
   UINT_t* A = (UINT_t *)calloc(m, sizeof(UINT_t));
   assert_malloc(A);
+  PHASE(PHASE_PREPROCESS);
 
   for (s = 0 ; s < n ; s++) {
     b = Ap[s  ];
@@ -921,16 +1037,18 @@ static UINT_t tc_forward_hash_skip_config_size(const GRAPH_TYPE *graph, UINT_t h
     for (UINT_t i=b ; i<e ; i++) {
       t  = Ai[i];
       if (s<t) {
-	count += intersectSizeHashSkip_forward(graph, Hash, s, t, A, Size);
+	count += intersectSizeHashSkip_forward(graph, &Hash, s, t, A, Size);
 	A[Ap[t] + Size[t]] = s;
 	Size[t]++;
       }
     }
   }
+  PHASE(PHASE_COUNT);
 
   free(A);
   free(Size);
-  free(Hash);
+  MARK(MARK_INTERSECT, free)(&Hash);
+  PHASE(PHASE_CLEANUP);
 
   return count;
 }
@@ -947,10 +1065,12 @@ UINT_t tc_forward_hash_degreeOrder(const GRAPH_TYPE *graph) {
 
   GRAPH_TYPE *graph2;
   graph2 = reorder_graph_by_degree(graph, REORDER_HIGHEST_DEGREE_FIRST);
+  PHASE(PHASE_PREPROCESS);
 
   count = tc_forward_hash(graph2);
 
   free_graph(graph2);
+  PHASE(PHASE_CLEANUP);
   
   return count;
 }
@@ -964,10 +1084,12 @@ UINT_t tc_forward_hash_degreeOrderReverse(const GRAPH_TYPE *graph) {
 
   GRAPH_TYPE *graph2;
   graph2 = reorder_graph_by_degree(graph, REORDER_LOWEST_DEGREE_FIRST);
+  PHASE(PHASE_PREPROCESS);
 
   count = tc_forward_hash(graph2);
 
   free_graph(graph2);
+  PHASE(PHASE_CLEANUP);
 
   return count;
 }
@@ -978,7 +1100,7 @@ UINT_t tc_forward_hash_degreeOrderReverse(const GRAPH_TYPE *graph) {
 UINT_t firstNeighborIndex(const GRAPH_TYPE *graph, UINT_t i) {
   
   const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
+  const VERTEX_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   UINT_t s = Ap[i];
@@ -996,7 +1118,7 @@ UINT_t firstNeighborIndex(const GRAPH_TYPE *graph, UINT_t i) {
 UINT_t nextNeighborIndex(const GRAPH_TYPE *graph, UINT_t i, UINT_t j) {
   
   const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
+  const VERTEX_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   UINT_t s = Ap[i];
@@ -1023,9 +1145,10 @@ UINT_t tc_compact_forward(const GRAPH_TYPE *graph) {
 
   GRAPH_TYPE *graph2;
   graph2 = reorder_graph_by_degree(graph, REORDER_HIGHEST_DEGREE_FIRST);
+  PHASE(PHASE_PREPROCESS);
 
   const UINT_t* restrict Ap = graph2->rowPtr;
-  const UINT_t* restrict Ai = graph2->colInd;
+  const VERTEX_t* restrict Ai = graph2->colInd;
   const UINT_t n = graph2->numVertices;
 
 
@@ -1055,14 +1178,16 @@ UINT_t tc_compact_forward(const GRAPH_TYPE *graph) {
       }
     }
   }
+  PHASE(PHASE_COUNT);
 
   free_graph(graph2);
+  PHASE(PHASE_CLEANUP);
   return count;
 }
 
 static void bfs_bader3(const GRAPH_TYPE *graph, const UINT_t startVertex, UINT_t* restrict level, Queue* queue, bool* visited) {
   const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
+  const VERTEX_t *restrict Ai = graph->colInd;
 
   visited[startVertex] = true;
   enqueue(queue, startVertex);
@@ -1082,33 +1207,17 @@ static void bfs_bader3(const GRAPH_TYPE *graph, const UINT_t startVertex, UINT_t
 }
 
 
-static void bader_intersectSizeMergePath(const GRAPH_TYPE* graph, const UINT_t* level, const UINT_t v, const UINT_t w, UINT_t* restrict c1, UINT_t* restrict c2) {
-  register UINT_t vb, ve, wb, we;
-  register UINT_t ptr_v, ptr_w;
-  UINT_t level_v;
-  
-  level_v = level[v];
-
-  vb = graph->rowPtr[v ];
-  ve = graph->rowPtr[v+1];
-  wb = graph->rowPtr[w  ];
-  we = graph->rowPtr[w+1];
-
-
-  ptr_v = vb;
-  ptr_w = wb;
-  while ((ptr_v < ve) && (ptr_w < we)) {
-    if (graph->colInd[ptr_v] == graph->colInd[ptr_w]) {
-      if (level_v == level[graph->colInd[ptr_v]]) (*c2)++;
-      else (*c1)++;
-      ptr_v++;
-      ptr_w++;
-    }
-    else
-      if (graph->colInd[ptr_v] < graph->colInd[ptr_w])
-	ptr_v++;
-      else
-	ptr_w++;
+/* The common neighbors of v and w, from intersect_list, counted by
+   whether they are on the level of v */
+static void bader_intersectSizeMergePath(const GRAPH_TYPE* graph, const UINT_t* level, const UINT_t v, const UINT_t w, VERTEX_t* restrict common, UINT_t* restrict c1, UINT_t* restrict c2) {
+  const UINT_t* restrict Ap = graph->rowPtr;
+  const VERTEX_t* restrict Ai = graph->colInd;
+  const UINT_t level_v = level[v];
+
+  const UINT_t num = intersect_list(Ai + Ap[v], Ap[v+1] - Ap[v], Ai + Ap[w], Ap[w+1] - Ap[w], common);
+  for (UINT_t i = 0 ; i < num ; i++) {
+    if (level_v == level[common[i]]) (*c2)++;
+    else (*c1)++;
   }
 
   return;
@@ -1135,6 +1244,7 @@ double tc_bader_compute_k(const GRAPH_TYPE *graph) {
     }
   }
 
+  VERTEX_t *common = intersect_alloc(graph);
   k = 0;
   
   c1 = 0; c2 = 0;
@@ -1146,11 +1256,12 @@ double tc_bader_compute_k(const GRAPH_TYPE *graph) {
       w = graph->colInd[j];
       if ((v < w) && (level[w] == l)) {
 	k++;
-	bader_intersectSizeMergePath(graph, level, v, w, &c1, &c2);
+	bader_intersectSizeMergePath(graph, level, v, w, common, &c1, &c2);
       }
     }
   }
 
+  free(common);
   free(level);
 
   return (2.0 * (double)k/(double)graph->numEdges);
@@ -1168,12 +1279,15 @@ UINT_t tc_bader(const GRAPH_TYPE *graph) {
   NO_LEVEL = graph->numVertices;
   for (UINT_t i = 0 ; i < graph->numVertices ; i++) 
     level[i] = NO_LEVEL;
+  VERTEX_t *common = intersect_alloc(graph);
+  PHASE(PHASE_PREPROCESS);
   
   for (UINT_t i = 0 ; i < graph->numVertices ; i++) {
     if (level[i] == NO_LEVEL) {
       bfs(graph, i, level);
     }
   }
+  PHASE(PHASE_BFS);
 
   c1 = 0; c2 = 0;
   for (UINT_t v = 0 ; v < graph->numVertices ; v++) {
@@ -1183,12 +1297,15 @@ UINT_t tc_bader(const GRAPH_TYPE *graph) {
     for (UINT_t j = s ; j<e ; j++) {
       w = graph->colInd[j];
       if ((v < w) && (level[w] == l))
-	bader_intersectSizeMergePath(graph, level, v, w, &c1, &c2);
+	bader_intersectSizeMergePath(graph, level, v, w, common, &c1, &c2);
     }
   }
+  PHASE(PHASE_COUNT);
 
 
+  free(common);
   free(level);
+  PHASE(PHASE_CLEANUP);
 
   return c1 + (c2/3);
 }
@@ -1202,10 +1319,10 @@ UINT_t tc_bader3(const GRAPH_TYPE *graph) {
   UINT_t* restrict level;
   UINT_t c1, c2;
   register UINT_t x;
-  bool* Hash;
+  MARK_T(MARK_BADER) Hash;
   bool* visited;
   const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
+  const VERTEX_t *restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   level = (UINT_t *)calloc(n, sizeof(UINT_t));
@@ -1214,8 +1331,7 @@ UINT_t tc_bader3(const GRAPH_TYPE *graph) {
   visited = (bool *)calloc(n, sizeof(bool));
   assert_malloc(visited);
 
-  Hash = (bool *)calloc(n, sizeof(bool));
-  assert_malloc(Hash);
+  MARK(MARK_BADER, alloc)(&Hash, n);
 
   Queue *queue = createQueue(n);
 
@@ -1227,8 +1343,9 @@ UINT_t tc_bader3(const GRAPH_TYPE *graph) {
     const UINT_t e = Ap[v+1];
     const UINT_t l = level[v];
 
+    MARK(MARK_BADER, next)(&Hash);
     for (UINT_t p = s ; p<e ; p++)
-      Hash[Ai[p]] = true;
+      MARK(MARK_BADER, set)(&Hash, Ai[p]);
     
     for (UINT_t j = s ; j<e ; j++) {
       const UINT_t w = Ai[j];
@@ -1236,7 +1353,7 @@ UINT_t tc_bader3(const GRAPH_TYPE *graph) {
 	/* bader_intersectSizeMergePath(graph, level, v, w, &c1, &c2); */
 	for (UINT_t k = Ap[w]; k < Ap[w+1] ; k++) {
 	  x = Ai[k];
-	  if (Hash[x]) {
+	  if (MARK(MARK_BADER, test)(&Hash, x)) {
 	    if (level[x] != l)
 	      c1++;
 	    else
@@ -1247,12 +1364,12 @@ UINT_t tc_bader3(const GRAPH_TYPE *graph) {
     }
 
     for (UINT_t p = s ; p<e ; p++)
-      Hash[Ai[p]] = false;
+      MARK(MARK_BADER, unset)(&Hash, Ai[p]);
   }
 
   free_queue(queue);
 
-  free(Hash);
+  MARK(MARK_BADER, free)(&Hash);
   free(visited);
   free(level);
 
@@ -1270,11 +1387,11 @@ UINT_t tc_bader4(const GRAPH_TYPE *graph) {
   UINT_t* restrict level;
   UINT_t c1, c2;
   register UINT_t x;
-  bool *Hash;
+  MARK_T(MARK_BADER) Hash;
   bool *horiz;
   bool *visited;
   const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
+  const VERTEX_t *restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
 
@@ -1284,24 +1401,28 @@ UINT_t tc_bader4(const GRAPH_TYPE *graph) {
   visited = (bool *)calloc(n, sizeof(bool));
   assert_malloc(visited);
 
-  Hash = (bool *)calloc(n, sizeof(bool));
-  assert_malloc(Hash);
+  MARK(MARK_BADER, alloc)(&Hash, n);
 
   horiz = (bool *)malloc(m * sizeof(bool));
   assert_malloc(horiz);
 
   Queue *queue = createQueue(n);
+  PHASE(PHASE_PREPROCESS);
 
   c1 = 0; c2 = 0;
   for (UINT_t v = 0 ; v < n ; v++) {
-    if (!level[v])
+    if (!level[v]) {
+      PHASE(PHASE_COUNT);
       bfs_mark_horizontal_edges(graph, v, level, queue, visited, horiz);
+      PHASE(PHASE_BFS);
+    }
     const UINT_t s = Ap[v  ];
     const UINT_t e = Ap[v+1];
     const UINT_t l = level[v];
 
+    MARK(MARK_BADER, next)(&Hash);
     for (UINT_t p = s ; p<e ; p++)
-      Hash[Ai[p]] = true;
+      MARK(MARK_BADER, set)(&Hash, Ai[p]);
     
     for (UINT_t j = s ; j<e ; j++) {
       if (horiz[j]) {
@@ -1309,7 +1430,7 @@ UINT_t tc_bader4(const GRAPH_TYPE *graph) {
 	if (v < w) {
 	  for (UINT_t k = Ap[w]; k < Ap[w+1] ; k++) {
 	    x = Ai[k];
-	    if (Hash[x]) {
+	    if (MARK(MARK_BADER, test)(&Hash, x)) {
 	      if (level[x] != l)
 		c1++;
 	      else
@@ -1321,15 +1442,17 @@ UINT_t tc_bader4(const GRAPH_TYPE *graph) {
     }
 
     for (UINT_t p = s ; p<e ; p++)
-      Hash[Ai[p]] = false;
+      MARK(MARK_BADER, unset)(&Hash, Ai[p]);
   }
+  PHASE(PHASE_COUNT);
 
   free_queue(queue);
 
-  free(Hash);
+  MARK(MARK_BADER, free)(&Hash);
   free(visited);
   free(level);
   free(horiz);
+  PHASE(PHASE_CLEANUP);
 
   return c1 + (c2/3);
 }
@@ -1343,7 +1466,11 @@ UINT_t tc_bader4_degreeOrder(const GRAPH_TYPE *graph) {
   /* Direction orientied. */
 
   GRAPH_TYPE *graph2 = reorder_graph_by_degree(graph, REORDER_HIGHEST_DEGREE_FIRST);
-  return tc_bader4(graph2);
+  PHASE(PHASE_PREPROCESS);
+  UINT_t count = tc_bader4(graph2);
+  free_graph(graph2);
+  PHASE(PHASE_CLEANUP);
+  return count;
 }
 
 
@@ -1357,11 +1484,11 @@ UINT_t tc_bader5(const GRAPH_TYPE *graph) {
   UINT_t* restrict level;
   UINT_t count;
   register UINT_t x;
-  bool *Hash;
+  MARK_T(MARK_BADER) Hash;
   bool *horiz;
   bool *visited;
   const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
+  const VERTEX_t *restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
 
@@ -1371,24 +1498,28 @@ UINT_t tc_bader5(const GRAPH_TYPE *graph) {
   visited = (bool *)calloc(n, sizeof(bool));
   assert_malloc(visited);
 
-  Hash = (bool *)calloc(n, sizeof(bool));
-  assert_malloc(Hash);
+  MARK(MARK_BADER, alloc)(&Hash, n);
 
   horiz = (bool *)malloc(m * sizeof(bool));
   assert_malloc(horiz);
 
   Queue *queue = createQueue(n);
+  PHASE(PHASE_PREPROCESS);
 
   count = 0;
   for (UINT_t v = 0 ; v < n ; v++) {
-    if (!level[v])
+    if (!level[v]) {
+      PHASE(PHASE_COUNT);
       bfs_mark_horizontal_edges(graph, v, level, queue, visited, horiz);
+      PHASE(PHASE_BFS);
+    }
     const UINT_t s = Ap[v  ];
     const UINT_t e = Ap[v+1];
     const UINT_t l = level[v];
 
+    MARK(MARK_BADER, next)(&Hash);
     for (UINT_t j = s ; j < e ; j++)
-      Hash[Ai[j]] = true;
+      MARK(MARK_BADER, set)(&Hash, Ai[j]);
     
     for (UINT_t j = s ; j < e ; j++) {
       if (horiz[j]) {
@@ -1396,7 +1527,7 @@ UINT_t tc_bader5(const GRAPH_TYPE *graph) {
 	if (v < w) {
 	  for (UINT_t k = Ap[w]; k < Ap[w+1] ; k++) {
 	    x = Ai[k];
-	    if (Hash[x]) {
+	    if (MARK(MARK_BADER, test)(&Hash, x)) {
 	      if ( (l != level[x]) || ((l == level[x]) && (w < x)) ) {
 		count++;
 	      }
@@ -1407,53 +1538,36 @@ UINT_t tc_bader5(const GRAPH_TYPE *graph) {
     }
 
     for (UINT_t j = s ; j < e ; j++)
-      Hash[Ai[j]] = false;
+      MARK(MARK_BADER, unset)(&Hash, Ai[j]);
   }
+  PHASE(PHASE_COUNT);
 
   free_queue(queue);
 
-  free(Hash);
+  MARK(MARK_BADER, free)(&Hash);
   free(visited);
   free(level);
   free(horiz);
+  PHASE(PHASE_CLEANUP);
 
   return count;
 }
 
 
-static UINT_t bader2_intersectSizeMergePath(const GRAPH_TYPE* graph, const UINT_t* restrict level, const UINT_t v, const UINT_t w) {
-  register UINT_t vb, ve, wb, we;
-  register UINT_t ptr_v, ptr_w;
-  UINT_t vlist, wlist, level_v;
+static UINT_t bader2_intersectSizeMergePath(const GRAPH_TYPE* graph, const UINT_t* restrict level, const UINT_t v, const UINT_t w, VERTEX_t* restrict common) {
+  const UINT_t* restrict Ap = graph->rowPtr;
+  const VERTEX_t* restrict Ai = graph->colInd;
+  const UINT_t level_v = level[v];
   UINT_t count = 0;
-  
-  level_v = level[v];
 
-  vb = graph->rowPtr[v ];
-  ve = graph->rowPtr[v+1];
-  wb = graph->rowPtr[w  ];
-  we = graph->rowPtr[w+1];
-
-
-  ptr_v = vb;
-  ptr_w = wb;
-  while ((ptr_v < ve) && (ptr_w < we)) {
-    vlist = graph->colInd[ptr_v];
-    wlist = graph->colInd[ptr_w];
-    if (vlist == wlist) {
-      if (level_v != level[vlist])
-	count++;
-      else
-	if ( (vlist < v) && (vlist < w) ) /* (level_v == level[vlist]) */ 
-	  count++;
-      ptr_v++;
-      ptr_w++;
-    }
+  const UINT_t num = intersect_list(Ai + Ap[v], Ap[v+1] - Ap[v], Ai + Ap[w], Ap[w+1] - Ap[w], common);
+  for (UINT_t i = 0 ; i < num ; i++) {
+    const UINT_t x = common[i];
+    if (level_v != level[x])
+      count++;
     else
-      if (vlist < wlist)
-	ptr_v++;
-      else
-	ptr_w++;
+      if ( (x < v) && (x < w) ) /* (level_v == level[x]) */
+	count++;
   }
 
   return count;
@@ -1473,12 +1587,15 @@ UINT_t tc_bader2(const GRAPH_TYPE *graph) {
   NO_LEVEL = graph->numVertices;
   for (UINT_t i = 0 ; i < graph->numVertices ; i++) 
     level[i] = NO_LEVEL;
+  VERTEX_t *common = intersect_alloc(graph);
+  PHASE(PHASE_PREPROCESS);
   
   for (UINT_t i = 0 ; i < graph->numVertices ; i++) {
     if (level[i] == NO_LEVEL) {
       bfs(graph, i, level);
     }
   }
+  PHASE(PHASE_BFS);
 
   for (UINT_t v = 0 ; v < graph->numVertices ; v++) {
     s = graph->rowPtr[v  ];
@@ -1487,12 +1604,15 @@ UINT_t tc_bader2(const GRAPH_TYPE *graph) {
     for (UINT_t j = s ; j<e ; j++) {
       w = graph->colInd[j];
       if ((v < w) && (level[w] == l)) {
-	count += bader2_intersectSizeMergePath(graph, level, v, w);
+	count += bader2_intersectSizeMergePath(graph, level, v, w, common);
       }
     }
   }
+  PHASE(PHASE_COUNT);
 
+  free(common);
   free(level);
+  PHASE(PHASE_CLEANUP);
 
   return count;
 }
@@ -1509,11 +1629,11 @@ UINT_t tc_bader_forward_hash(const GRAPH_TYPE *graph) {
   /* Direction oriented. */
   UINT_t* level;
   UINT_t count;
-  bool *Hash;
+  MARK_T(MARK_BADER) Hash;
   bool *horiz;
   bool *visited;
   const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
+  const VERTEX_t *restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
 
@@ -1523,13 +1643,13 @@ UINT_t tc_bader_forward_hash(const GRAPH_TYPE *graph) {
   visited = (bool *)calloc(n, sizeof(bool));
   assert_malloc(visited);
 
-  Hash = (bool *)calloc(n, sizeof(bool));
-  assert_malloc(Hash);
+  MARK(MARK_BADER, alloc)(&Hash, n);
 
   horiz = (bool *)malloc(m * sizeof(bool));
   assert_malloc(horiz);
 
   Queue *queue = createQueue(n);
+  PHASE(PHASE_PREPROCESS);
 
   for (UINT_t v=0 ; v<n ; v++)
     if (!level[v])
@@ -1537,6 +1657,7 @@ UINT_t tc_bader_forward_hash(const GRAPH_TYPE *graph) {
 
   free_queue(queue);
   free(visited);
+  PHASE(PHASE_BFS);
 
   GRAPH_TYPE *graph0 = (GRAPH_TYPE *)malloc(sizeof(GRAPH_TYPE));
   assert_malloc(graph0);
@@ -1544,7 +1665,7 @@ UINT_t tc_bader_forward_hash(const GRAPH_TYPE *graph) {
   graph0->numEdges = m;
   allocate_graph(graph0);
   UINT_t* restrict Ap0 = graph0->rowPtr;
-  UINT_t* restrict Ai0 = graph0->colInd;
+  VERTEX_t* restrict Ai0 = graph0->colInd;
 
   GRAPH_TYPE *graph1 = (GRAPH_TYPE *)malloc(sizeof(GRAPH_TYPE));
   assert_malloc(graph1);
@@ -1552,7 +1673,7 @@ UINT_t tc_bader_forward_hash(const GRAPH_TYPE *graph) {
   graph1->numEdges = m;
   allocate_graph(graph1);
   UINT_t* restrict Ap1 = graph1->rowPtr;
-  UINT_t* restrict Ai1 = graph1->colInd;
+  VERTEX_t* restrict Ai1 = graph1->colInd;
 
   UINT_t edgeCountG0 = 0;
   UINT_t edgeCountG1 = 0;
@@ -1581,8 +1702,9 @@ UINT_t tc_bader_forward_hash(const GRAPH_TYPE *graph) {
 
   graph0->numEdges = edgeCountG0;
   graph1->numEdges = edgeCountG1;
+  PHASE(PHASE_PARTITION);
 
-  count = tc_forward_hash_config_size(graph0, m);
+  count = tc_forward_hash_config_size(graph0, 0);
 
   for (UINT_t v=0 ; v<n ; v++) {
     register const UINT_t s0 = Ap0[v  ];
@@ -1592,31 +1714,42 @@ UINT_t tc_bader_forward_hash(const GRAPH_TYPE *graph) {
 
     if (s1<e1) {
 
+      MARK(MARK_BADER, next)(&Hash);
       for (UINT_t j=s1 ; j<e1 ; j++)
-	Hash[Ai1[j]] = true;
+	MARK(MARK_BADER, set)(&Hash, Ai1[j]);
     
       for (UINT_t j=s0 ; j<e0 ; j++) {
 	register const UINT_t w = Ai0[j];
 	if (v < w) {
-	  for (UINT_t k = Ap1[w]; k < Ap1[w+1] ; k++) {
-	    if (Hash[Ai1[k]]) {
-	      count++;
+	  /* v and w are on the same level, so the non-horizontal neighbors
+	     of v adjacent to w are non-horizontal neighbors of w: test the
+	     short list of v in the bitmap of a hub w instead of scanning
+	     the long list of w */
+	  const INT_t hw = (HUB_SHORTER * (e1 - s1) < Ap1[w+1] - Ap1[w]) ? hub_of(graph, w) : -1;
+	  if (hw >= 0)
+	    count += hub_count(hw, Ai1 + s1, e1 - s1);
+	  else
+	    for (UINT_t k = Ap1[w]; k < Ap1[w+1] ; k++) {
+	      if (MARK(MARK_BADER, test)(&Hash, Ai1[k])) {
+		count++;
+	      }
 	    }
-	  }
 	}
       }
 
       for (UINT_t j=s1 ; j<e1 ; j++)
-	Hash[Ai1[j]] = false;
+	MARK(MARK_BADER, unset)(&Hash, Ai1[j]);
     }
   }
+  PHASE(PHASE_COUNT);
   
   free_graph(graph1);
   free_graph(graph0);
 
   free(horiz);
-  free(Hash);
+  MARK(MARK_BADER, free)(&Hash);
   free(level);
+  PHASE(PHASE_CLEANUP);
 
   return count;
 }
@@ -1631,8 +1764,10 @@ UINT_t tc_bader_forward_hash_degreeOrder(const GRAPH_TYPE *graph) {
 
 
   GRAPH_TYPE *graph2 = reorder_graph_by_degree(graph, REORDER_HIGHEST_DEGREE_FIRST);
+  PHASE(PHASE_PREPROCESS);
   UINT_t count = tc_bader_forward_hash(graph2);
   free_graph(graph2);
+  PHASE(PHASE_CLEANUP);
   return count;
 }
 
@@ -1648,11 +1783,12 @@ UINT_t tc_bader_recursive(const GRAPH_TYPE *graph) {
   /* Direction oriented. */
   UINT_t* level;
   UINT_t count;
-  bool *Hash, *Hash2;
+  MARK_T(MARK_BADER) Hash;
+  bool *Hash2;
   bool *horiz;
   bool *visited;
   const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
+  const VERTEX_t *restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
 
@@ -1662,8 +1798,7 @@ UINT_t tc_bader_recursive(const GRAPH_TYPE *graph) {
   visited = (bool *)calloc(n, sizeof(bool));
   assert_malloc(visited);
 
-  Hash = (bool *)calloc(n, sizeof(bool));
-  assert_malloc(Hash);
+  MARK(MARK_BADER, alloc)(&Hash, n);
 
   Hash2 = (bool *)calloc(n, sizeof(bool));
   assert_malloc(Hash2);
@@ -1672,6 +1807,7 @@ UINT_t tc_bader_recursive(const GRAPH_TYPE *graph) {
   assert_malloc(horiz);
 
   Queue *queue = createQueue(n);
+  PHASE(PHASE_PREPROCESS);
 
   for (UINT_t v=0 ; v<n ; v++)
     if (!level[v])
@@ -1679,6 +1815,7 @@ UINT_t tc_bader_recursive(const GRAPH_TYPE *graph) {
 
   free_queue(queue);
   free(visited);
+  PHASE(PHASE_BFS);
 
 
 
@@ -1688,7 +1825,7 @@ UINT_t tc_bader_recursive(const GRAPH_TYPE *graph) {
   graph0->numEdges = m;
   allocate_graph(graph0);
   UINT_t* restrict Ap0 = graph0->rowPtr;
-  UINT_t* restrict Ai0 = graph0->colInd;
+  VERTEX_t* restrict Ai0 = graph0->colInd;
 
   GRAPH_TYPE *graph1 = (GRAPH_TYPE *)malloc(sizeof(GRAPH_TYPE));
   assert_malloc(graph1);
@@ -1696,7 +1833,7 @@ UINT_t tc_bader_recursive(const GRAPH_TYPE *graph) {
   graph1->numEdges = m;
   allocate_graph(graph1);
   UINT_t* restrict Ap1 = graph1->rowPtr;
-  UINT_t* restrict Ai1 = graph1->colInd;
+  VERTEX_t* restrict Ai1 = graph1->colInd;
 
   UINT_t edgeCountG0 = 0;
   UINT_t edgeCountG1 = 0;
@@ -1729,6 +1866,7 @@ UINT_t tc_bader_recursive(const GRAPH_TYPE *graph) {
 
   graph0->numEdges = edgeCountG0;
   graph1->numEdges = edgeCountG1;
+  PHASE(PHASE_PARTITION);
 
   /* Calculate G1 */
   
@@ -1741,14 +1879,15 @@ UINT_t tc_bader_recursive(const GRAPH_TYPE *graph) {
 
     if (s1<e1) {
 
+      MARK(MARK_BADER, next)(&Hash);
       for (UINT_t j=s1 ; j<e1 ; j++)
-	Hash[Ai1[j]] = true;
+	MARK(MARK_BADER, set)(&Hash, Ai1[j]);
     
       for (UINT_t j=s0 ; j<e0 ; j++) {
 	register const UINT_t w = Ai0[j];
 	if (v<w) {
 	  for (UINT_t k = Ap1[w]; k < Ap1[w+1] ; k++) {
-	    if (Hash[Ai1[k]]) {
+	    if (MARK(MARK_BADER, test)(&Hash, Ai1[k])) {
 	      count++;
 	    }
 	  }
@@ -1756,15 +1895,16 @@ UINT_t tc_bader_recursive(const GRAPH_TYPE *graph) {
       }
 
       for (UINT_t j=s1 ; j<e1 ; j++)
-	Hash[Ai1[j]] = false;
+	MARK(MARK_BADER, unset)(&Hash, Ai1[j]);
     }
   }
+  PHASE(PHASE_COUNT);
   
   /* Calculate G0 */
 
 
   if (edgeCountG0 < _BADER_RECURSIVE_BASE ) {
-    count += tc_forward_hash_config_size(graph0, m);
+    count += tc_forward_hash_config_size(graph0, 0);
   }
   else {
 
@@ -1785,7 +1925,7 @@ UINT_t tc_bader_recursive(const GRAPH_TYPE *graph) {
     allocate_graph(graphr0);
 
     UINT_t* restrict Apr0 = graphr0->rowPtr;
-    UINT_t* restrict Air0 = graphr0->colInd;
+    VERTEX_t* restrict Air0 = graphr0->colInd;
 
     for (UINT_t e=0 ; e<edgeCountG0 ; e++) {
       Air0[e] = Vlist[Ai0[e]];
@@ -1798,17 +1938,20 @@ UINT_t tc_bader_recursive(const GRAPH_TYPE *graph) {
     Apr0[vn] = edgeCountG0;
     free(Vlist);
     free(Hash2);
+    PHASE(PHASE_PARTITION);
 
     count += tc_bader_recursive(graphr0);
     free_graph(graphr0);
+    PHASE(PHASE_CLEANUP);
   }
   
   free_graph(graph1);
   free_graph(graph0);
 
   free(horiz);
-  free(Hash);
+  MARK(MARK_BADER, free)(&Hash);
   free(level);
+  PHASE(PHASE_CLEANUP);
 
   return count;
 }
@@ -1821,9 +1964,11 @@ UINT_t tc_bader_level(const GRAPH_TYPE *graph, UINT_t * level) {
   UINT_t c1, c2;
 
   const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
+  const VERTEX_t *restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
+  VERTEX_t *common = intersect_alloc(graph);
+
   c1 = 0; c2 = 0;
   for (UINT_t v=0 ; v<n ; v++) {
     s = Ap[v  ];
@@ -1832,10 +1977,12 @@ UINT_t tc_bader_level(const GRAPH_TYPE *graph, UINT_t * level) {
     for (UINT_t j = s ; j<e ; j++) {
       w = Ai[j];
       if ((v < w) && (level[w] == l))
-	bader_intersectSizeMergePath(graph, level, v, w, &c1, &c2);
+	bader_intersectSizeMergePath(graph, level, v, w, common, &c1, &c2);
     }
   }
 
+  free(common);
+
   return c1 + (c2/3);
 }
 
@@ -1854,7 +2001,7 @@ UINT_t tc_bader_hybrid(const GRAPH_TYPE *graph) {
   bool *horiz;
   bool *visited;
   const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
+  const VERTEX_t *restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
 
@@ -1873,6 +2020,7 @@ UINT_t tc_bader_hybrid(const GRAPH_TYPE *graph) {
   assert_malloc(horiz);
 
   Queue *queue = createQueue(n);
+  PHASE(PHASE_PREPROCESS);
 
   for (UINT_t v=0 ; v<n ; v++)
     if (!level[v])
@@ -1883,6 +2031,7 @@ UINT_t tc_bader_hybrid(const GRAPH_TYPE *graph) {
 #endif
   free_queue(queue);
   free(visited);
+  PHASE(PHASE_BFS);
 
   UINT_t k = 0;
   
@@ -1899,12 +2048,15 @@ UINT_t tc_bader_hybrid(const GRAPH_TYPE *graph) {
   }
 
   double pk=2.0 * (double)k/(double)graph->numEdges;
+  PHASE(PHASE_PARTITION);
   if (graph->numEdges<_BADER_RECURSIVE_BASE || pk> 0.7)
     count = tc_forward_hash(graph) ;
   else
     count = tc_bader_level(graph, level);
+  PHASE(PHASE_COUNT);
 
   free(level);
+  PHASE(PHASE_CLEANUP);
   return count;
 }
 
@@ -1916,10 +2068,10 @@ UINT_t tc_bader_new_bfs(const GRAPH_TYPE *graph) {
   /* Direction oriented. */
   UINT_t* level;
   UINT_t c1, c2;
-  bool *Hash;
+  MARK_T(MARK_BADER) Hash;
   bool *visited;
   const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
+  const VERTEX_t *restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
 
@@ -1929,8 +2081,7 @@ UINT_t tc_bader_new_bfs(const GRAPH_TYPE *graph) {
   visited = (bool *)calloc(n, sizeof(bool));
   assert_malloc(visited);
 
-  Hash = (bool *)calloc(n, sizeof(bool));
-  assert_malloc(Hash);
+  MARK(MARK_BADER, alloc)(&Hash, n);
 
   Queue *queue = createQueue(n);
 
@@ -1950,8 +2101,9 @@ UINT_t tc_bader_new_bfs(const GRAPH_TYPE *graph) {
 
 	UINT_t dv = e-s;
 
+	MARK(MARK_BADER, next)(&Hash);
 	for (UINT_t x = s; x < e ; x++)
-	  Hash[Ai[x]] = true;
+	  MARK(MARK_BADER, set)(&Hash, Ai[x]);
 	
 	for (UINT_t j = s; j < e ; j++) {
 	  UINT_t w = Ai[j];
@@ -1969,7 +2121,7 @@ UINT_t tc_bader_new_bfs(const GRAPH_TYPE *graph) {
 
 	      for (UINT_t k = sw; k < ew ; k++) {
 	        UINT_t y = Ai[k];
-		if (Hash[y]) {
+		if (MARK(MARK_BADER, test)(&Hash, y)) {
 		  if (level[y] != lv)
 		    c1++;
 		  else
@@ -1983,13 +2135,13 @@ UINT_t tc_bader_new_bfs(const GRAPH_TYPE *graph) {
 	}
 	
 	for (UINT_t x = s; x < e ; x++)
-	  Hash[Ai[x]] = false;
+	  MARK(MARK_BADER, unset)(&Hash, Ai[x]);
 
       }
     }
 
   free_queue(queue);
-  free(Hash);
+  MARK(MARK_BADER, free)(&Hash);
   free(visited);
   free(level);
 
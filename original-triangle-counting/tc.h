@@ -20,10 +20,13 @@ UINT_t tc_intersectPartition(const GRAPH_TYPE *);
 UINT_t tc_intersectPartition_DO(const GRAPH_TYPE *);
 UINT_t tc_intersectHash(const GRAPH_TYPE *);
 UINT_t tc_intersectHash_DO(const GRAPH_TYPE *);
+UINT_t tc_intersectAdaptive(const GRAPH_TYPE *);
+UINT_t tc_intersectAdaptive_DO(const GRAPH_TYPE *);
 UINT_t tc_low(const GRAPH_TYPE *);
 UINT_t tc_treelist(const GRAPH_TYPE *);
 UINT_t tc_treelist2(const GRAPH_TYPE *);
 UINT_t tc_forward(const GRAPH_TYPE *);
+UINT_t tc_forward_adaptive(const GRAPH_TYPE *);
 UINT_t tc_forward_hash(const GRAPH_TYPE *);
 UINT_t tc_forward_hash_skip(const GRAPH_TYPE *);
 UINT_t tc_forward_hash_degreeOrder(const GRAPH_TYPE *);
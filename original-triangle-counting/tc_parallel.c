@@ -4,15 +4,30 @@
 #include "graph.h"
 #include "bfs.h"
 #include "tc_parallel.h"
+#include "placement.h"
+#include "phase.h"
+#include "hub.h"
+#include "intersect.h"
 #include <unistd.h>
 #include <omp.h>
 
+/* Each thread reads the replica of the graph on its own NUMA node
+   (-N replicate); the same graph otherwise. The loop bodies of the
+   kernels use its Ap and Ai, so the kernels do not declare their own. */
+#define PLOCAL						      \
+  const GRAPH_TYPE *localGraph = local_graph(graph);	      \
+  const GRAPH_TYPE *graph = localGraph;			      \
+  const UINT_t* restrict Ap = graph->rowPtr;		      \
+  const VERTEX_t* restrict Ai = graph->colInd;		      \
+  (void)Ap; (void)Ai;
+
 #define PBODY(foo)				\
   int numThreads;				\
   UINT_t *mycount;				\
   _Pragma("omp parallel")			\
   {							      \
   int myID = omp_get_thread_num();			      \
+  PLOCAL						      \
   if (myID == 0) {					      \
     numThreads = omp_get_num_threads();			      \
     mycount = (UINT_t *)calloc(numThreads, sizeof(UINT_t));   \
@@ -33,6 +48,7 @@
   _Pragma("omp parallel")				\
   {							\
   int myID = omp_get_thread_num();			      \
+  PLOCAL						      \
   if (myID == 0) {					      \
       numThreads = omp_get_num_threads();		      \
       mycount = (UINT_t *)calloc(numThreads, sizeof(UINT_t)); \
@@ -47,6 +63,32 @@
     count += mycount[i];				      \
   }
 
+/* PBODY with a marker of the given kind for n vertices in each thread,
+   myMark, allocated by the thread itself so that it is local to its
+   NUMA node */
+#define PBODY_MARK(kind, n, foo)			\
+  int numThreads;					\
+  UINT_t *mycount;					\
+  _Pragma("omp parallel")				\
+  {							\
+  int myID = omp_get_thread_num();			      \
+  PLOCAL						      \
+  MARK_T(kind) myMark;					      \
+  MARK(kind, alloc)(&myMark, n);			      \
+  if (myID == 0) {					      \
+    numThreads = omp_get_num_threads();			      \
+    mycount = (UINT_t *)calloc(numThreads, sizeof(UINT_t));   \
+    assert_malloc(mycount);				      \
+  }							      \
+  _Pragma("omp barrier")				      \
+  _Pragma("omp for schedule(dynamic)")			      \
+  foo							      \
+  _Pragma("omp for reduction(+:count)")			      \
+  for (int i = 0; i < numThreads ; i++)			      \
+    count += mycount[i];				      \
+  MARK(kind, free)(&myMark);				      \
+  }
+
 #define myCount mycount[myID]
 
   
@@ -92,8 +134,6 @@ UINT_t tc_wedge_P(const GRAPH_TYPE *graph) {
   /* Algorithm: For each vertex i, for each open wedge (j, i, k), determine if there's a closing edge (j, k) */
   UINT_t count = 0;
 
-  const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   PBODY(
@@ -133,8 +173,6 @@ UINT_t tc_wedge_DO_P(const GRAPH_TYPE *graph) {
   
   UINT_t count = 0;
 
-  const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   PBODY(
@@ -175,8 +213,6 @@ UINT_t tc_intersectMergePath_P(const GRAPH_TYPE *graph) {
   
   UINT_t count = 0;
 
-  const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   PBODY(
@@ -199,8 +235,6 @@ UINT_t tc_intersectMergePath_DO_P(const GRAPH_TYPE *graph) {
   
   UINT_t count = 0;
 
-  const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   PBODY(
@@ -224,8 +258,6 @@ UINT_t tc_intersectBinarySearch_P(const GRAPH_TYPE *graph) {
 
   UINT_t count = 0;
 
-  const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   PBODY(
@@ -248,8 +280,6 @@ UINT_t tc_intersectBinarySearch_DO_P(const GRAPH_TYPE *graph) {
 
   UINT_t count = 0;
 
-  const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   PBODY(
@@ -273,8 +303,6 @@ UINT_t tc_intersectPartition_P(const GRAPH_TYPE *graph) {
   
   UINT_t count = 0;
 
-  const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   PBODY(
@@ -283,7 +311,7 @@ UINT_t tc_intersectPartition_P(const GRAPH_TYPE *graph) {
 	  UINT_t e = Ap[v+1];
 	  for (UINT_t i=b ; i<e ; i++) {
 	    UINT_t w  = Ai[i];
-	    myCount += searchLists_with_partitioning((UINT_t *)Ai, (INT_t) Ap[v], (INT_t)Ap[v+1]-1, (UINT_t *)Ai, (INT_t)Ap[w], (INT_t)Ap[w+1]-1);
+	    myCount += searchLists_with_partitioning(Ai, (INT_t) Ap[v], (INT_t)Ap[v+1]-1, Ai, (INT_t)Ap[w], (INT_t)Ap[w+1]-1);
 	  }
 	}
 	);
@@ -297,8 +325,6 @@ UINT_t tc_intersectPartition_DO_P(const GRAPH_TYPE *graph) {
   
   UINT_t count = 0;
 
-  const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   PBODY(
@@ -308,7 +334,7 @@ UINT_t tc_intersectPartition_DO_P(const GRAPH_TYPE *graph) {
 	  for (UINT_t i=b ; i<e ; i++) {
 	    UINT_t w  = Ai[i];
 	    if (v < w)
-	      myCount += searchLists_with_partitioning((UINT_t *)Ai, (INT_t) Ap[v], (INT_t)Ap[v+1]-1, (UINT_t *)Ai, (INT_t)Ap[w], (INT_t)Ap[w+1]-1);
+	      myCount += searchLists_with_partitioning(Ai, (INT_t) Ap[v], (INT_t)Ap[v+1]-1, Ai, (INT_t)Ap[w], (INT_t)Ap[w+1]-1);
 	  }
 	}
 	);
@@ -322,28 +348,19 @@ UINT_t tc_intersectHash_P(const GRAPH_TYPE *graph) {
 
   UINT_t count = 0;
 
-  bool *Hash;
-  
-  const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
-  PBODY2(
+  PBODY_MARK(MARK_INTERSECT, n,
 	for (UINT_t v = 0; v < n ; v++) {
 	  UINT_t b = Ap[v  ];
 	  UINT_t e = Ap[v+1];
 	  for (UINT_t i=b ; i<e ; i++) {
 	    UINT_t w  = Ai[i];
-	    myCount += intersectSizeHash(graph, Hash + (myID * n), v, w);
+	    myCount += intersectSizeHash(graph, &myMark, v, w);
 	  }
 	}
-	,
-	 Hash = (bool *)calloc(n * omp_get_num_threads(), sizeof(bool));
-	 assert_malloc(Hash);
 	);
 
-  free(Hash);
-
   return (count/6);
 }
 
@@ -356,29 +373,69 @@ UINT_t tc_intersectHash_DO_P(const GRAPH_TYPE *graph) {
 
   UINT_t count = 0;
 
-  bool *Hash;
-
-  const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
 
-  PBODY2(
+  PBODY_MARK(MARK_INTERSECT, n,
 	 for (UINT_t v = 0; v < n ; v++) {
 	   UINT_t b = Ap[v  ];
 	   UINT_t e = Ap[v+1];
 	   for (UINT_t i=b ; i<e ; i++) {
 	     UINT_t w  = Ai[i];
 	     if (v < w)
-	       myCount += intersectSizeHash(graph, Hash + (myID * n), v, w);
+	       myCount += intersectSizeHash(graph, &myMark, v, w);
 	   }
 	   }
-	 ,
-	 Hash = (bool *)calloc(n * omp_get_num_threads(), sizeof(bool));
-	 assert_malloc(Hash);
 	 );
 
-  free(Hash);
+  return (count/3);
+}
+
+
+
+UINT_t tc_intersectAdaptive_P(const GRAPH_TYPE *graph) {
+  /* Algorithm: For each edge (i, j), find the size of its intersection using merge, hash or galloping by the ratio of the degrees. */
+
+  UINT_t count = 0;
+
+  const UINT_t n = graph->numVertices;
+
+  PBODY_MARK(MARK_INTERSECT, n,
+	for (UINT_t v = 0; v < n ; v++) {
+	  UINT_t b = Ap[v  ];
+	  UINT_t e = Ap[v+1];
+	  for (UINT_t i=b ; i<e ; i++) {
+	    UINT_t w  = Ai[i];
+	    myCount += intersectSizeAdaptive(graph, &myMark, v, w);
+	  }
+	}
+	);
+
+  return (count/6);
+}
+
+
+
+
+UINT_t tc_intersectAdaptive_DO_P(const GRAPH_TYPE *graph) {
+  /* Algorithm: For each edge (i, j), find the size of its intersection using merge, hash or galloping by the ratio of the degrees. */
+  /* Direction oriented. */
+
+  UINT_t count = 0;
+
+  const UINT_t n = graph->numVertices;
+
+  PBODY_MARK(MARK_INTERSECT, n,
+	 for (UINT_t v = 0; v < n ; v++) {
+	   UINT_t b = Ap[v  ];
+	   UINT_t e = Ap[v+1];
+	   for (UINT_t i=b ; i<e ; i++) {
+	     UINT_t w  = Ai[i];
+	     if (v < w)
+	       myCount += intersectSizeAdaptive(graph, &myMark, v, w);
+	   }
+	   }
+	 );
 
   return (count/3);
 }
@@ -387,7 +444,7 @@ UINT_t tc_intersectHash_DO_P(const GRAPH_TYPE *graph) {
 
 void bfs_mark_horizontal_edges_P(const GRAPH_TYPE *graph, const UINT_t startVertex, UINT_t* restrict level, Queue* queue, bool* visited, bool* horiz) {
   const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
+  const VERTEX_t *restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
 
   UINT_t listsize;
@@ -464,11 +521,10 @@ UINT_t tc_bader_bfs1_P(const GRAPH_TYPE *graph) {
   /* Direction orientied. */
   UINT_t* restrict level;
   UINT_t c1, c2;
-  static bool *Hash;
   bool *horiz;
   bool *visited;
   const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
+  const VERTEX_t *restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
 
@@ -482,11 +538,13 @@ UINT_t tc_bader_bfs1_P(const GRAPH_TYPE *graph) {
   assert_malloc(horiz);
 
   Queue *queue = createQueue(n);
+  PHASE(PHASE_PREPROCESS);
 
   for (UINT_t v = 0 ; v < n ; v++) {
     if (!level[v])
       bfs_mark_horizontal_edges(graph, v, level, queue, visited, horiz);
   }
+  PHASE(PHASE_BFS);
 
   static int numThreads;
   static UINT_t *myc1;
@@ -494,9 +552,11 @@ UINT_t tc_bader_bfs1_P(const GRAPH_TYPE *graph) {
 
   c1 = 0; c2 = 0;
 #pragma omp parallel \
-  shared(numThreads, myc1, myc2, Hash, Ap, Ai, level)
+  shared(numThreads, myc1, myc2, Ap, Ai, level)
   { //temporary change: removed n and m from shared list
     int myID = omp_get_thread_num();
+    MARK_T(MARK_BADER) myHash;
+    MARK(MARK_BADER, alloc)(&myHash, n);
     if (myID==0) {
       numThreads = omp_get_num_threads();
       
@@ -504,21 +564,17 @@ UINT_t tc_bader_bfs1_P(const GRAPH_TYPE *graph) {
       assert_malloc(myc1);
       myc2 = (UINT_t *)calloc(numThreads, sizeof(UINT_t));
       assert_malloc(myc2);
-  
-      Hash = (bool *)calloc(n * numThreads, sizeof(bool));
-      assert_malloc(Hash);
     }
 #pragma omp barrier
 #pragma omp for schedule(dynamic)
     for (UINT_t v = 0 ; v < n ; v++) {
-      bool *myHash = Hash + (n * myID);
-    
       const UINT_t s = Ap[v  ];
       const UINT_t e = Ap[v+1];
       const UINT_t l = level[v];
 
+      MARK(MARK_BADER, next)(&myHash);
       for (UINT_t p = s ; p<e ; p++)
-	myHash[Ai[p]] = true;
+	MARK(MARK_BADER, set)(&myHash, Ai[p]);
 
       for (UINT_t j = s ; j<e ; j++) {
 	if (horiz[j]) {
@@ -526,7 +582,7 @@ UINT_t tc_bader_bfs1_P(const GRAPH_TYPE *graph) {
 	  if (v < w) {
 	    for (UINT_t k = Ap[w]; k < Ap[w+1] ; k++) {
 	      UINT_t x = Ai[k];
-	      if (myHash[x]) {
+	      if (MARK(MARK_BADER, test)(&myHash, x)) {
 		if (level[x] != l) {
 		  myc1[myID]++;
 		}
@@ -540,7 +596,7 @@ UINT_t tc_bader_bfs1_P(const GRAPH_TYPE *graph) {
       }
 
       for (UINT_t p = s ; p<e ; p++)
-	myHash[Ai[p]] = false;
+	MARK(MARK_BADER, unset)(&myHash, Ai[p]);
     }
 
 #pragma omp for reduction(+:c1,c2)
@@ -548,14 +604,16 @@ UINT_t tc_bader_bfs1_P(const GRAPH_TYPE *graph) {
       c1 += myc1[i];
       c2 += myc2[i];
     }
+    MARK(MARK_BADER, free)(&myHash);
   }
+  PHASE(PHASE_COUNT);
 
   free_queue(queue);
 
-  free(Hash);
   free(visited);
   free(level);
   free(horiz);
+  PHASE(PHASE_CLEANUP);
 
   return c1 + (c2/3);
 }
@@ -569,11 +627,10 @@ static UINT_t tc_bader_bfs_core_P(const GRAPH_TYPE* graph, void (*f)(const GRAPH
   /* Direction orientied. */
   UINT_t* restrict level;
   UINT_t c1, c2;
-  static bool *Hash;
   bool *visited;
 
   const UINT_t *restrict Ap = graph->rowPtr;
-  const UINT_t *restrict Ai = graph->colInd;
+  const VERTEX_t *restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
   const UINT_t m = graph->numEdges;
 
@@ -584,11 +641,13 @@ static UINT_t tc_bader_bfs_core_P(const GRAPH_TYPE* graph, void (*f)(const GRAPH
   assert_malloc(visited);
 
   Queue *queue = createQueue(n);
+  PHASE(PHASE_PREPROCESS);
 
   for (UINT_t v = 0 ; v < n ; v++) {
     if (!visited[v])
       (*f)(graph, v, level, visited);
   }
+  PHASE(PHASE_BFS);
 
   static int numThreads;
   static UINT_t *myc1;
@@ -596,9 +655,11 @@ static UINT_t tc_bader_bfs_core_P(const GRAPH_TYPE* graph, void (*f)(const GRAPH
 
   c1 = 0; c2 = 0;
 #pragma omp parallel \
-  shared(numThreads, myc1, myc2, Hash, Ap, Ai, level)
+  shared(numThreads, myc1, myc2, Ap, Ai, level)
   { //temporary change: removed n and m from shared list
     int myID = omp_get_thread_num();
+    MARK_T(MARK_BADER) myHash;
+    MARK(MARK_BADER, alloc)(&myHash, n);
     if (myID==0) {
       numThreads = omp_get_num_threads();
       
@@ -606,28 +667,30 @@ static UINT_t tc_bader_bfs_core_P(const GRAPH_TYPE* graph, void (*f)(const GRAPH
       assert_malloc(myc1);
       myc2 = (UINT_t *)calloc(numThreads, sizeof(UINT_t));
       assert_malloc(myc2);
-  
-      Hash = (bool *)calloc(n * numThreads, sizeof(bool));
-      assert_malloc(Hash);
     }
 #pragma omp barrier
 #pragma omp for schedule(dynamic)
     for (UINT_t v = 0 ; v < n ; v++) {
-      bool *myHash = Hash + (n * myID);
-    
       const UINT_t s = Ap[v  ];
       const UINT_t e = Ap[v+1];
       const UINT_t l = level[v];
 
+      MARK(MARK_BADER, next)(&myHash);
       for (UINT_t p = s ; p<e ; p++)
-	myHash[Ai[p]] = true;
+	MARK(MARK_BADER, set)(&myHash, Ai[p]);
 
       for (UINT_t j = s ; j<e ; j++) {
 	const UINT_t w = Ai[j];
 	if ((v<w) && (l == level[w])) {
-	  for (UINT_t k = Ap[w]; k < Ap[w+1] ; k++) {
+	  /* Test the short list of v in the bitmap of a hub w instead of
+	     scanning the long list of w */
+	  const INT_t hw = (HUB_SHORTER * (e - s) < Ap[w+1] - Ap[w]) ? hub_of(graph, w) : -1;
+	  const bool useHub = (hw >= 0);
+	  const UINT_t kb = useHub ? s : Ap[w];
+	  const UINT_t ke = useHub ? e : Ap[w+1];
+	  for (UINT_t k = kb; k < ke ; k++) {
 	    UINT_t x = Ai[k];
-	    if (myHash[x]) {
+	    if (useHub ? hub_test(hw, x) : MARK(MARK_BADER, test)(&myHash, x)) {
 	      if (level[x] != l) {
 		myc1[myID]++;
 	      }
@@ -640,7 +703,7 @@ static UINT_t tc_bader_bfs_core_P(const GRAPH_TYPE* graph, void (*f)(const GRAPH
       }
 
       for (UINT_t p = s ; p<e ; p++)
-	myHash[Ai[p]] = false;
+	MARK(MARK_BADER, unset)(&myHash, Ai[p]);
     }
 
 #pragma omp for reduction(+:c1,c2)
@@ -648,13 +711,15 @@ static UINT_t tc_bader_bfs_core_P(const GRAPH_TYPE* graph, void (*f)(const GRAPH
       c1 += myc1[i];
       c2 += myc2[i];
     }
+    MARK(MARK_BADER, free)(&myHash);
   }
+  PHASE(PHASE_COUNT);
   
   free_queue(queue);
 
   free(visited);
-  free(Hash);
   free(level);
+  PHASE(PHASE_CLEANUP);
 
   return c1 + (c2/3);
 }
@@ -685,48 +750,126 @@ UINT_t tc_bader_bfs_locks_P(const GRAPH_TYPE *graph) {
 }
 
 
-UINT_t tc_forward_hash_P(const GRAPH_TYPE *graph) {
-  
+/* Chunks of vertices per thread of tc_forward_hash_P and
+   tc_forward_merge_P, of about equal estimated work, handed out
+   dynamically */
+#define FORWARD_CHUNKS_PER_THREAD  16
+
+static UINT_t tc_forward_core_P(const GRAPH_TYPE *graph, const bool useHash) {
+
 /* Schank, T., Wagner, D. (2005). Finding, Counting and Listing All Triangles in Large Graphs, an Experimental Study. In: Nikoletseas, S.E. (eds) Experimental and Efficient Algorithms. WEA 2005. Lecture Notes in Computer Science, vol 3503. Springer, Berlin, Heidelberg. https://doi.org/10.1007/11427186_54 */
 
-  register UINT_t s, t;
-  register UINT_t b, e;
+  /* The forward algorithm with the oriented adjacency computed up front:
+     L(v) is the neighbors of v below v (a prefix of its sorted row), and
+     every edge (s, t), s < t, adds |L(s) ^ L(t)|, so each triangle
+     u < s < t is counted once, at (s, t). The vertices t are independent
+     and are counted in parallel, each thread marking L(t) in its own
+     marker (useHash) or merging L(t) with each L(s). */
+
   UINT_t count = 0;
 
   const UINT_t* restrict Ap = graph->rowPtr;
-  const UINT_t* restrict Ai = graph->colInd;
+  const VERTEX_t* restrict Ai = graph->colInd;
   const UINT_t n = graph->numVertices;
-  const UINT_t m = graph->numEdges;
+  const UINT_t numChunks = min(n, (UINT_t)omp_get_max_threads() * FORWARD_CHUNKS_PER_THREAD);
 
-  bool* Hash = (bool *)calloc(m, sizeof(bool));
-  assert_malloc(Hash);
+  UINT_t* Lp = (UINT_t *)malloc((n + 1) * sizeof(UINT_t));
+  assert_malloc(Lp);
+  uint64_t* work = (uint64_t *)malloc((n + 1) * sizeof(uint64_t));
+  assert_malloc(work);
+  UINT_t* chunk = (UINT_t *)malloc((numChunks + 1) * sizeof(UINT_t));
+  assert_malloc(chunk);
 
-  UINT_t* Size = (UINT_t *)calloc(n, sizeof(UINT_t));
-  assert_malloc(Size);
-  
-  UINT_t* A = (UINT_t *)calloc(m, sizeof(UINT_t));
-  assert_malloc(A);
-
-  for (s = 0; s < n ; s++) {
-    b = Ap[s  ];
-    e = Ap[s+1];
-    for (UINT_t i=b ; i<e ; i++) {
-      t  = Ai[i];
-      if (s<t) {
-	count += intersectSizeHash_forward_P(graph, Hash, s, t, A, Size);
-	A[Ap[t] + Size[t]] = s;
-	Size[t]++;
-      }
+  /* Lengths of the lower lists: the first neighbor of v that is not below v */
+#pragma omp parallel for schedule(static)
+  for (UINT_t v = 0 ; v < n ; v++) {
+    UINT_t lo = Ap[v], hi = Ap[v+1];
+    while (lo < hi) {
+      const UINT_t mid = lo + (hi - lo) / 2;
+      if (Ai[mid] < v) lo = mid + 1; else hi = mid;
     }
+    Lp[v+1] = lo - Ap[v];
   }
+  Lp[0] = 0;
+  for (UINT_t v = 0 ; v < n ; v++)
+    Lp[v+1] += Lp[v];
+
+  VERTEX_t* Li = (VERTEX_t *)malloc(max(Lp[n], 1) * sizeof(VERTEX_t));
+  assert_malloc(Li);
+
+#pragma omp parallel for schedule(static)
+  for (UINT_t v = 0 ; v < n ; v++)
+    memcpy(Li + Lp[v], Ai + Ap[v], (Lp[v+1] - Lp[v]) * sizeof(VERTEX_t));
+
+  /* Work of t: L(t) and each L(s) it is intersected with, then chunks
+     of about equal shares of the total */
+#pragma omp parallel for schedule(dynamic, 1024)
+  for (UINT_t t = 0 ; t < n ; t++) {
+    uint64_t w = Lp[t+1] - Lp[t];
+    for (UINT_t i = Lp[t] ; i < Lp[t+1] ; i++)
+      w += Lp[Li[i]+1] - Lp[Li[i]];
+    work[t+1] = w;
+  }
+  work[0] = 0;
+  for (UINT_t v = 0 ; v < n ; v++)
+    work[v+1] += work[v];
+
+  chunk[0] = 0;
+  for (UINT_t c = 1, v = 0 ; c < numChunks ; c++) {
+    const uint64_t target = work[n] / numChunks * c;
+    while ((v < n) && (work[v] < target)) v++;
+    chunk[c] = v;
+  }
+  chunk[numChunks] = n;
+  free(work);
+  PHASE(PHASE_PREPROCESS);
+
+  PBODY_MARK(MARK_FORWARD, useHash ? n : 0,
+	 for (UINT_t c = 0 ; c < numChunks ; c++) {
+	   UINT_t myTriangles = 0;
+	   for (UINT_t t = chunk[c] ; t < chunk[c+1] ; t++) {
+	     const UINT_t tb = Lp[t];
+	     const UINT_t te = Lp[t+1];
+	     if (useHash) {
+	       MARK(MARK_FORWARD, next)(&myMark);
+	       for (UINT_t i = tb ; i < te ; i++)
+		 MARK(MARK_FORWARD, set)(&myMark, Li[i]);
+	       for (UINT_t i = tb ; i < te ; i++) {
+		 const UINT_t s = Li[i];
+		 for (UINT_t k = Lp[s] ; k < Lp[s+1] ; k++)
+		   myTriangles += MARK(MARK_FORWARD, test)(&myMark, Li[k]);
+	       }
+	       for (UINT_t i = tb ; i < te ; i++)
+		 MARK(MARK_FORWARD, unset)(&myMark, Li[i]);
+	     }
+	     else
+	       for (UINT_t i = tb ; i < te ; i++) {
+		 const UINT_t s = Li[i];
+		 myTriangles += intersect_count(Li + Lp[s], Lp[s+1] - Lp[s], Li + tb, te - tb);
+	       }
+	   }
+	   myCount += myTriangles;
+	 }
+	 );
+  PHASE(PHASE_COUNT);
+
+  free(Li);
+  free(chunk);
+  free(Lp);
+  free(mycount);
+  PHASE(PHASE_CLEANUP);
 
-  free(A);
-  free(Size);
-  free(Hash);
-  
   return count;
 }
 
+UINT_t tc_forward_hash_P(const GRAPH_TYPE *graph) {
+  return tc_forward_core_P(graph, true);
+}
+
+UINT_t tc_forward_merge_P(const GRAPH_TYPE *graph) {
+  return tc_forward_core_P(graph, false);
+}
+
 
 
 int intCompare(const void * a, const void * b) {
@@ -755,12 +898,13 @@ int intCompare(const void * a, const void * b) {
 GRAPH_TYPE *ptc_Preprocess(const GRAPH_TYPE *originalGraph)
 {
   int32_t vi, nvtxs, nthreads, maxdegree=0, csrange=0;
-#if 0
+#ifdef WIDE
   ssize_t *xadj, *nxadj, *psums;
 #else
   int32_t *xadj, *nxadj, *psums;
 #endif
-  int32_t *adjncy, *nadjncy, *perm=NULL, *iperm=NULL, *chunkptr=NULL;
+  const VERTEX_t *adjncy;
+  int32_t *nadjncy, *perm=NULL, *iperm=NULL, *chunkptr=NULL;
   int32_t *gcounts;
   GRAPH_TYPE *graph;
 
@@ -771,24 +915,27 @@ GRAPH_TYPE *ptc_Preprocess(const GRAPH_TYPE *originalGraph)
   }
 
   nvtxs  = (int32_t)originalGraph->numVertices;
-#if 0
+#ifdef WIDE
   xadj   = (ssize_t *)originalGraph->rowPtr;
 #else
   xadj   = (int32_t *)originalGraph->rowPtr;
 #endif
-  adjncy = (int32_t *)originalGraph->colInd;
+  adjncy = originalGraph->colInd;
 
   graph = (GRAPH_TYPE *)malloc(sizeof(GRAPH_TYPE));
   assert_malloc(graph);
   graph->numVertices = nvtxs;
   graph->numEdges = /* nvtxs+xadj[nvtxs] */ xadj[nvtxs];
-  /* graph->rowPtr   = nxadj = (ssize_t *)malloc((nvtxs+1) * sizeof(ssize_t)); */
+#ifdef WIDE
+  nxadj = (ssize_t *)malloc((nvtxs+1) * sizeof(ssize_t));
+#else
   nxadj = (int32_t *)malloc((nvtxs+1) * sizeof(int32_t));
+#endif
   assert_malloc(nxadj);
   graph->rowPtr = (UINT_t *)nxadj;
   nadjncy = (int32_t *)malloc((nvtxs+xadj[nvtxs]) * sizeof(int32_t));
   assert_malloc(nadjncy);
-  graph->colInd = (UINT_t *)nadjncy;
+  graph->colInd = (VERTEX_t *)nadjncy; /* int32_t entries, only read back below */
   
   perm  = (int32_t *)malloc(nvtxs * sizeof(int32_t));
   assert_malloc(perm);
@@ -808,7 +955,7 @@ GRAPH_TYPE *ptc_Preprocess(const GRAPH_TYPE *originalGraph)
 
   gcounts = (int32_t *)malloc((nthreads*csrange) * sizeof(int32_t));
   assert_malloc(gcounts);
-#if 0
+#ifdef WIDE
   psums   = (ssize_t *)malloc(nthreads * sizeof(ssize_t));
 #else
   psums   = (int32_t *)malloc(nthreads * sizeof(int32_t));
@@ -821,7 +968,7 @@ GRAPH_TYPE *ptc_Preprocess(const GRAPH_TYPE *originalGraph)
     int32_t vi, vistart, viend, vj, nedges, nchunks;
     int32_t ti, di, ci, dstart, dend;
     int32_t *counts, *buffer;
-#if 0
+#ifdef WIDE
     ssize_t ej, ejend, psum, chunksize;
 #else
     int32_t ej, ejend, psum, chunksize;
@@ -994,13 +1141,13 @@ GRAPH_TYPE *ptc_Preprocess(const GRAPH_TYPE *originalGraph)
 UINT_t tc_MapJIK_P(const GRAPH_TYPE *originalGraph)
 {
   int32_t vi, vj, nvtxs, startv;
-#if 0
+#ifdef WIDE
   ssize_t ei, ej;
 #else
   int32_t ei, ej;
 #endif
   int64_t ntriangles=0;
-#if 0
+#ifdef WIDE
   ssize_t *xadj, *uxadj;
 #else
   int32_t *xadj, *uxadj;
@@ -1012,14 +1159,14 @@ UINT_t tc_MapJIK_P(const GRAPH_TYPE *originalGraph)
   graph = ptc_Preprocess(originalGraph);
 
   nvtxs  = (int32_t)graph->numVertices;
-#if 0
+#ifdef WIDE
   xadj   = (ssize_t *)graph->rowPtr;
 #else
   xadj   = (int32_t *)graph->rowPtr;
 #endif
   adjncy = (int32_t *)graph->colInd;
 
-#if 0
+#ifdef WIDE
   uxadj = (ssize_t *)malloc(nvtxs * sizeof(ssize_t)); /* the locations of the upper triangular part */
 #else
   uxadj = (int32_t *)malloc(nvtxs * sizeof(int32_t)); /* the locations of the upper triangular part */
@@ -1052,6 +1199,7 @@ UINT_t tc_MapJIK_P(const GRAPH_TYPE *originalGraph)
      bitwise AND operation */
   for (l2=1; maxhmsize>(1<<l2); l2++);
   maxhmsize = (1<<(l2+4))-1;
+  PHASE(PHASE_PREPROCESS);
 
 #if 0
   printf("& compatible maxhmsize: %"PRId32", startv: %d\n", maxhmsize, startv);
@@ -1069,7 +1217,7 @@ UINT_t tc_MapJIK_P(const GRAPH_TYPE *originalGraph)
     reduction(+: ntriangles)
   {
     int32_t vi, vj, vk, vl, nlocal;
-#if 0
+#ifdef WIDE
     ssize_t ei, eiend, eistart, ej, ejend, ejstart;
 #else
     int32_t ei, eiend, eistart, ej, ejend, ejstart;
@@ -1193,9 +1341,11 @@ UINT_t tc_MapJIK_P(const GRAPH_TYPE *originalGraph)
 
     free(hmap);
   }
+  PHASE(PHASE_COUNT);
 
   free_graph(graph);
   free(uxadj);
+  PHASE(PHASE_CLEANUP);
 
   return (UINT_t)ntriangles;
 }
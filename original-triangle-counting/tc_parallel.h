@@ -15,7 +15,10 @@ UINT_t tc_intersectPartition_P(const GRAPH_TYPE *);
 UINT_t tc_intersectPartition_DO_P(const GRAPH_TYPE *);
 UINT_t tc_intersectHash_P(const GRAPH_TYPE *);
 UINT_t tc_intersectHash_DO_P(const GRAPH_TYPE *);
+UINT_t tc_intersectAdaptive_P(const GRAPH_TYPE *);
+UINT_t tc_intersectAdaptive_DO_P(const GRAPH_TYPE *);
 UINT_t tc_forward_hash_P(const GRAPH_TYPE *);
+UINT_t tc_forward_merge_P(const GRAPH_TYPE *);
 UINT_t tc_bader_bfs1_P(const GRAPH_TYPE *);
 UINT_t tc_bader_bfs3_P(const GRAPH_TYPE *);
 UINT_t tc_bader_bfs_visited_P(const GRAPH_TYPE *);
@@ -5,17 +5,36 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <math.h>
 #include <limits.h>
 #include <strings.h>
 #include <stdbool.h>
 #include <sys/time.h>
+#include <time.h>
 #include <stdbool.h>
 
+#include "mem.h"
+
+/* Wide build (-DWIDE): row pointers, edge counts and triangle counts are
+   64-bit. Adding -DVERTEX32 keeps the column indices (vertex IDs) 32-bit,
+   which halves the size of colInd. */
+#ifdef WIDE
+#define UINT_t uint64_t
+#define INT_t int64_t
+#define PRIUINT PRIu64
+#ifdef VERTEX32
+#define VERTEX_t uint32_t
+#define PRIVERTEX PRIu32
+#endif
+#endif
+
 #ifdef ICX
+#ifndef UINT_t
 #define UINT_t uint
 #define INT_t int
 #endif
+#endif
 
 #ifndef UINT_t
 #define UINT_t uint32_t
@@ -23,12 +42,19 @@
 #ifndef INT_t
 #define INT_t int32_t
 #endif
+#ifndef PRIUINT
+#define PRIUINT "u"
+#endif
+#ifndef VERTEX_t
+#define VERTEX_t UINT_t
+#define PRIVERTEX PRIUINT
+#endif
 
 typedef struct {
     UINT_t numVertices;
     UINT_t numEdges;
     UINT_t* rowPtr;
-    UINT_t* colInd;
+    VERTEX_t* colInd;
 } GRAPH_TYPE;
 
 typedef struct {
@@ -37,10 +63,19 @@ typedef struct {
 } edge_t;
 
 
-static struct timeval  tp;
-static struct timezone tzp;
-#define get_seconds()   (gettimeofday(&tp, &tzp),			\
-                        (double)tp.tv_sec + (double)tp.tv_usec / 1000000.0)
+#ifdef GCC
+#define INLINE inline
+/* #define INLINE */
+#else
+#define INLINE
+#endif
+
+/* Monotonic, so intervals are not disturbed by clock adjustments */
+static INLINE double get_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1.0e9;
+}
 
 #define ODD(n) ((n)&1)==1
 #define max(a,b) ((a)>(b)?(a):(b))
@@ -63,12 +98,6 @@ extern bool PARALLEL_MAX;
 extern int  PARALLEL_PROCS;
 #endif
 
-#ifdef GCC
-#define INLINE inline
-/* #define INLINE */
-#else
-#define INLINE
-#endif
 
 
 #endif